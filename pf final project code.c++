@@ -8,41 +8,459 @@
 #include <ctime> // Provides functions to deal with date and time
 #include <sstream> // For stringstream and ostringstream
 #include <algorithm> // For all_of
-#include <regex>  // Include regex library for email validation
+#include <regex>  // Include regex library for email validation (now only for --bench-parse)
 #include <limits> // Defines limits for data types (e.g., numeric limits for int, float)
 #include <stdexcept>  // For exceptions, allowing you to handle errors in a more controlled manner.
+#include <map> // Ordered map, used to keep journal bookings in booking order
+#include <unordered_map> // Hash map, used to find a room's open booking directly
+#include <cstdio> // snprintf, rename
+#include <cstdlib> // atoi, atoll
+#include <cstdint> // Fixed-width integer types
+#include <cerrno> // errno
+#include <fcntl.h> // open
+#include <unistd.h> // write, pread, fsync, ftruncate
+#include <sys/stat.h> // stat, for file sizes
+#include <sys/mman.h> // mmap, for reading the journal on startup
+#include <cstring> // memcpy, memchr
+#include <chrono> // steady_clock, for the startup benchmark
+#include <string_view> // Views into the room table's string arena
+#include <thread> // Journal writer and stress test threads
+#include <mutex> // Room and state locks of the hotel service
+#include <condition_variable> // Waiting for the journal writer
+#include <atomic> // Stress test counters
+#include <charconv> // from_chars, for reading numbers out of string_views
+#include <climits> // INT_MIN and INT_MAX, for open-ended report date ranges
 
 
 using namespace std;
 
-// Room Structure
-struct Room {
-    int roomNumber;  // Room number (e.g., 10,20 ,etc.)
-    bool isBooked;  // Boolean flag to indicate if the room is booked or not
-    string customerName; // Name of the customer who booked the room
+// ---------------------------------------------------------------------------
+// Room table
+//
+// Rooms are stored column by column. The fields the availability and summary scans
+// read (room number, booked flag, type) each have their own dense array; price,
+// amenities and guest details are kept in separate, colder arrays. Room types and
+// amenities are stored once and referred to by id and bit, and the guests' strings
+// are packed back to back in a single arena.
+// ---------------------------------------------------------------------------
+
+// Position and length of a string inside the arena
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Details of the guest who booked a room
+struct RoomGuest {
+    StringRef customerName; // Name of the customer who booked the room
+    StringRef contactNumber;
+    StringRef emailAddress;
+    StringRef numberOfDays;
+    StringRef checkInTime;
+    StringRef checkOutTime;
+    uint8_t paymentMethod;  // Index into kPaymentMethods
+};
+
+const char* const kPaymentMethods[] = { "", "Cash", "Credit" };
+
+struct RoomTable {
+    // Hot columns
+    vector<int> roomNumber;      // Room number (e.g., 10,20 ,etc.)
+    vector<uint8_t> isBooked;    // 1 if the room is booked
+    vector<uint8_t> typeId;      // Index into typeNames
+    // Cold columns
+    vector<int> pricePerDay;     // Price for the room per day
+    vector<uint32_t> amenities;  // Bit i set = the room has amenityNames[i]
+    vector<RoomGuest> guest;
+    // Interned text
+    vector<string> typeNames;    // Room types (e.g., Single, Double, Suite)
+    vector<string> amenityNames;
+    string arena;                // Guest strings, back to back
+    size_t arenaLiveBytes;       // Bytes of the arena still used by a room
+
+    RoomTable() : arenaLiveBytes(0) {}
+};
+
+// Function to get the id of a room type, adding it if it is new
+int internRoomType(RoomTable& table, const string& type) {
+    for (size_t i = 0; i < table.typeNames.size(); ++i) {
+        if (table.typeNames[i] == type) {
+            return i;
+        }
+    }
+    table.typeNames.push_back(type);
+    return table.typeNames.size() - 1;
+}
+
+// Function to get the bit of an amenity, adding it if it is new
+uint32_t internAmenity(RoomTable& table, const string& amenity) {
+    for (size_t i = 0; i < table.amenityNames.size(); ++i) {
+        if (table.amenityNames[i] == amenity) {
+            return 1u << i;
+        }
+    }
+    table.amenityNames.push_back(amenity);
+    return 1u << (table.amenityNames.size() - 1);
+}
+
+// Function to get the id of a payment method (0 if it is not Cash or Credit)
+uint8_t paymentMethodId(const string& paymentMethod) {
+    for (uint8_t i = 1; i < sizeof(kPaymentMethods) / sizeof(kPaymentMethods[0]); ++i) {
+        if (paymentMethod == kPaymentMethods[i]) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// Function to add a free room to the table and return its position
+size_t addRoom(RoomTable& table, int roomNumber, const string& type, int pricePerDay, uint32_t amenities) {
+    table.roomNumber.push_back(roomNumber);
+    table.isBooked.push_back(0);
+    table.typeId.push_back(internRoomType(table, type));
+    table.pricePerDay.push_back(pricePerDay);
+    table.amenities.push_back(amenities);
+    table.guest.push_back(RoomGuest());
+    return table.roomNumber.size() - 1;
+}
+
+// Function to read a guest string from the arena
+string_view roomText(const RoomTable& table, StringRef text) {
+    return string_view(table.arena.data() + text.offset, text.length);
+}
+
+// Function to store a guest string in the arena
+void setRoomText(RoomTable& table, StringRef& field, string_view value) {
+    table.arenaLiveBytes -= field.length;
+    field.offset = table.arena.size();
+    field.length = value.size();
+    table.arena.append(value.data(), value.size());
+    table.arenaLiveBytes += value.size();
+}
+
+// Function to copy the live guest strings into a fresh arena, dropping the ones no room uses
+void compactArena(RoomTable& table) {
+    string arena;
+    arena.reserve(table.arenaLiveBytes);
+    for (size_t i = 0; i < table.guest.size(); ++i) {
+        StringRef* fields[] = { &table.guest[i].customerName, &table.guest[i].contactNumber, &table.guest[i].emailAddress,
+                                &table.guest[i].numberOfDays, &table.guest[i].checkInTime, &table.guest[i].checkOutTime };
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f) {
+            string_view value = roomText(table, *fields[f]);
+            fields[f]->offset = arena.size();
+            arena.append(value.data(), value.size());
+        }
+    }
+    table.arena.swap(arena);
+}
+
+// Function to clear a room's guest details when it is checked out
+void clearRoomGuest(RoomTable& table, size_t slot) {
+    RoomGuest& guest = table.guest[slot];
+    table.arenaLiveBytes -= guest.customerName.length + guest.contactNumber.length + guest.emailAddress.length +
+                            guest.numberOfDays.length + guest.checkInTime.length + guest.checkOutTime.length;
+    guest = RoomGuest();
+    // Compact once more than half of a sizeable arena is garbage
+    if (table.arena.size() > 4096 && table.arena.size() > 2 * table.arenaLiveBytes) {
+        compactArena(table);
+    }
+}
+
+// A booking as taken at the front desk
+struct BookingRequest {
+    int roomNumber;
+    string customerName;
     string contactNumber;
     string emailAddress;
     string numberOfDays;
-    string type;  // Room type (e.g., Single, Double, Suite)
-    int pricePerDay;  // Price for the room per day
     string paymentMethod; // "Cash" or "Credit"
-    vector<string> amenities;
-    string checkInTime;
-    string checkOutTime;
+    int arrivalDay;       // Day number of the first night
+};
+
+// Function to put a guest into a room
+void occupyRoom(RoomTable& table, size_t slot, const BookingRequest& request) {
+    RoomGuest& guest = table.guest[slot];
+    table.isBooked[slot] = 1;
+    setRoomText(table, guest.customerName, request.customerName);
+    setRoomText(table, guest.contactNumber, request.contactNumber);
+    setRoomText(table, guest.emailAddress, request.emailAddress);
+    setRoomText(table, guest.numberOfDays, request.numberOfDays);
+    setRoomText(table, guest.checkInTime, "");
+    setRoomText(table, guest.checkOutTime, "");
+    guest.paymentMethod = paymentMethodId(request.paymentMethod);
+}
+
+// Function to count the bytes the room table uses, including its heap storage
+size_t roomTableBytes(const RoomTable& table) {
+    size_t bytes = sizeof(table) + table.roomNumber.capacity() * sizeof(int) + table.isBooked.capacity() +
+                   table.typeId.capacity() + table.pricePerDay.capacity() * sizeof(int) +
+                   table.amenities.capacity() * sizeof(uint32_t) + table.guest.capacity() * sizeof(RoomGuest) +
+                   table.arena.capacity();
+    for (size_t i = 0; i < table.typeNames.size(); ++i) bytes += sizeof(string) + table.typeNames[i].capacity();
+    for (size_t i = 0; i < table.amenityNames.size(); ++i) bytes += sizeof(string) + table.amenityNames[i].capacity();
+    return bytes;
+}
+
+// ---------------------------------------------------------------------------
+// Validation and parsing
+//
+// Input checks and record splitting, all on string_views, without allocating.
+// Characters are classified with one table lookup, digit strings are checked
+// eight bytes at a time, and delimiters are found with memchr, which the C
+// library vectorizes. `--bench-parse` compares these with the versions they replaced.
+// ---------------------------------------------------------------------------
+
+const uint8_t kDigitChar = 1;
+const uint8_t kLetterChar = 2;
+const uint8_t kSpaceChar = 4;  // The characters isspace accepts
+const uint8_t kHyphenChar = 8;
+const uint8_t kUnderscoreChar = 16;
+const uint8_t kWordChar = kDigitChar | kLetterChar | kUnderscoreChar; // \w
+
+struct CharClassTable {
+    uint8_t classes[256];
+};
+
+// Function to build the character class table (evaluated at compile time)
+constexpr CharClassTable makeCharClassTable() {
+    CharClassTable table = {};
+    for (int c = '0'; c <= '9'; ++c) table.classes[c] |= kDigitChar;
+    for (int c = 'a'; c <= 'z'; ++c) table.classes[c] |= kLetterChar;
+    for (int c = 'A'; c <= 'Z'; ++c) table.classes[c] |= kLetterChar;
+    const char spaces[] = " \t\n\v\f\r";
+    for (int i = 0; spaces[i] != '\0'; ++i) table.classes[(unsigned char)spaces[i]] |= kSpaceChar;
+    table.classes['-'] |= kHyphenChar;
+    table.classes['_'] |= kUnderscoreChar;
+    return table;
+}
+
+constexpr CharClassTable kCharClasses = makeCharClassTable();
+
+// Function to check that every character of a text is in one of the allowed classes
+bool allCharsIn(string_view text, uint8_t allowed) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        if ((kCharClasses.classes[(unsigned char)text[i]] & allowed) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to check that a text is all digits, testing eight bytes per step:
+// a byte is a digit if subtracting '0' does not wrap and adding 0x46 stays below 0x80
+bool isAllDigits(string_view text) {
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        uint64_t word;
+        memcpy(&word, text.data() + i, sizeof(word));
+        if (((word - 0x3030303030303030ULL) | (word + 0x4646464646464646ULL)) & 0x8080808080808080ULL) {
+            return false;
+        }
+    }
+    return allCharsIn(text.substr(i), kDigitChar);
+}
+
+// Function to read a whole field as a number. Returns false if anything else is in it.
+bool parseNumber(string_view text, long long& value) {
+    from_chars_result result = from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == errc() && result.ptr == text.data() + text.size() && !text.empty();
+}
+
+// Function to read a numeric field, or 0 if it is not a number (like atoll)
+long long fieldNumber(string_view text) {
+    long long value = 0;
+    from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+const size_t kMaxFields = 12; // More than any journal record or batch command has
+
+// Function to cut a comma separated record into views of its fields.
+// Returns the number of fields, or maxFields + 1 if there are more than maxFields.
+size_t tokenizeFields(string_view record, string_view* fields, size_t maxFields) {
+    if (record.empty()) {
+        return 0;
+    }
+    const char* start = record.data();
+    const char* end = start + record.size();
+    size_t count = 0;
+    while (true) {
+        if (count == maxFields) {
+            return maxFields + 1;
+        }
+        const char* comma = static_cast<const char*>(memchr(start, ',', end - start));
+        fields[count++] = string_view(start, (comma != NULL ? comma : end) - start);
+        if (comma == NULL) {
+            return count;
+        }
+        start = comma + 1;
+    }
+}
+
+// Function to check an email against ^[\w-]+(\.[\w-]+)*@[a-zA-Z0-9-]+(\.[a-zA-Z]{2,})+$
+// by hand, instead of building a std::regex on every call
+bool isValidEmail(string_view emailAddress) {
+    const char* at = static_cast<const char*>(memchr(emailAddress.data(), '@', emailAddress.size()));
+    if (at == NULL) {
+        return false;
+    }
+    string_view local = emailAddress.substr(0, at - emailAddress.data());
+    string_view domain = emailAddress.substr(at - emailAddress.data() + 1);
+
+    // Local part: non-empty runs of word characters and hyphens, separated by single dots
+    size_t runStart = 0;
+    for (size_t i = 0; i <= local.size(); ++i) {
+        if (i == local.size() || local[i] == '.') {
+            if (i == runStart) {
+                return false;
+            }
+            runStart = i + 1;
+        } else if ((kCharClasses.classes[(unsigned char)local[i]] & (kWordChar | kHyphenChar)) == 0) {
+            return false;
+        }
+    }
+
+    // Domain: a label of letters, digits and hyphens, then one or more labels of 2+ letters
+    const char* dot = static_cast<const char*>(memchr(domain.data(), '.', domain.size()));
+    if (dot == NULL || dot == domain.data() ||
+        !allCharsIn(domain.substr(0, dot - domain.data()), kLetterChar | kDigitChar | kHyphenChar)) {
+        return false;
+    }
+    size_t labelStart = dot - domain.data() + 1;
+    for (size_t i = labelStart; i <= domain.size(); ++i) {
+        if (i == domain.size() || domain[i] == '.') {
+            if (i - labelStart < 2) {
+                return false;
+            }
+            labelStart = i + 1;
+        } else if ((kCharClasses.classes[(unsigned char)domain[i]] & kLetterChar) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to check a card number's Luhn check digit
+bool passesLuhn(string_view digits) {
+    int sum = 0;
+    bool doubled = false;
+    for (size_t i = digits.size(); i-- > 0; doubled = !doubled) {
+        int digit = digits[i] - '0';
+        if (doubled) {
+            digit = (digit * 2 > 9) ? digit * 2 - 9 : digit * 2;
+        }
+        sum += digit;
+    }
+    return sum % 10 == 0;
+}
+
+// Function to check a customer name: letters, spaces or hyphens only
+bool isValidCustomerName(string_view customerName) {
+    return !customerName.empty() && allCharsIn(customerName, kLetterChar | kSpaceChar | kHyphenChar);
+}
+
+// Function to check a contact number: digits only, 7-15 characters
+bool isValidContactNumber(string_view contactNumber) {
+    return contactNumber.length() >= 7 && contactNumber.length() <= 15 && isAllDigits(contactNumber);
+}
+
+// Function to check that an email has '@' before a '.' that is not last, and no commas
+bool isValidGuestEmail(string_view emailAddress) {
+    const char* data = emailAddress.data();
+    size_t size = emailAddress.size();
+    const char* at = static_cast<const char*>(memchr(data, '@', size));
+    const char* dot = static_cast<const char*>(memchr(data, '.', size));
+    return at != NULL && dot != NULL && at < dot && dot != data + size - 1 && memchr(data, ',', size) == NULL;
+}
+
+// Function to check the number of days of a stay: a positive integer of at most 3 digits
+bool isValidStayLength(string_view numberOfDays) {
+    return !numberOfDays.empty() && numberOfDays.size() <= 3 && isAllDigits(numberOfDays) && fieldNumber(numberOfDays) > 0;
+}
+
+// Function to check the payment method
+bool isValidPaymentMethod(string_view paymentMethod) {
+    return paymentMethod == "Cash" || paymentMethod == "Credit";
+}
+
+// Function to parse a room number made of digits only
+bool parseRoomNumber(string_view text, int& roomNumber) {
+    if (text.empty() || text.size() > 9 || !isAllDigits(text)) {
+        return false;
+    }
+    roomNumber = fieldNumber(text);
+    return true;
+}
+
+// Function to get the local time, converted once per second (localtime checks the
+// time zone file on every call, which dominates batch mode otherwise)
+const tm* currentLocalTime() {
+    static thread_local time_t convertedAt = -1;
+    static thread_local tm converted;
+    time_t now = time(0);
+    if (now != convertedAt) {
+        localtime_r(&now, &converted);
+        convertedAt = now;
+    }
+    return &converted;
+}
 
-    // Constructor
-    Room(int num, bool booked, const string& name, const string& roomType )
-        : roomNumber(num), isBooked(booked), customerName(name),type(roomType), checkInTime(""), checkOutTime("") {}
-}; 
 // Function to get the current date and time as a string
 string getCurrentTime() {
-    time_t now = time(0);
-    tm* ltm = localtime(&now);
+    const tm* ltm = currentLocalTime();
     char buffer[80];
     strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", ltm);
     return string(buffer);
 }
 
+// Function to turn a calendar date into a day number (days since 1970-01-01)
+int dayNumber(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Function to turn a day number back into a YYYY-MM-DD string
+string formatDay(int dayNumber) {
+    int shifted = dayNumber + 719468;
+    int era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+    int dayOfEra = shifted - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    int year = yearOfEra + era * 400 + (month <= 2);
+    char buffer[32]; // Room for any int year, month and day
+    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    return string(buffer);
+}
+
+// Function to parse a YYYY-MM-DD date into a day number
+bool parseDay(string_view text, int& result) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-' || !isAllDigits(text.substr(0, 4)) ||
+        !isAllDigits(text.substr(5, 2)) || !isAllDigits(text.substr(8, 2))) {
+        return false;
+    }
+    int year = fieldNumber(text.substr(0, 4));
+    int month = fieldNumber(text.substr(5, 2));
+    int day = fieldNumber(text.substr(8, 2));
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    result = dayNumber(year, month, day);
+    return formatDay(result) == text; // Rejects dates such as 2025-02-30
+}
+
+// Function to get today's day number
+int currentDay() {
+    const tm* ltm = currentLocalTime();
+    return dayNumber(ltm->tm_year + 1900, ltm->tm_mon + 1, ltm->tm_mday);
+}
+
 // Function to display the welcome screen
 void displayWelcomeScreen() {
     cout << "\033[38;5;223m*************************************************" << endl;
@@ -67,371 +485,2331 @@ void displayHotelDescription() {
 }
  
 // Function to display room details
-void displayRoomDetails(Room& room) {
+void displayRoomDetails(const RoomTable& table, size_t slot) {
     cout << "\033[38;5;129m*************************************************" << endl;
     cout << "*              FEATURES OF THIS ROOM            *" << endl;
     cout << "*************************************************\033[0m" << endl;
-    cout << "\033[38;5;214mRoom Number: " << room.roomNumber << endl;
-    cout << "Room Type: " << room.type << endl;
-    cout << "Price Per Day: Rs:" << room.pricePerDay << endl;
+    cout << "\033[38;5;214mRoom Number: " << table.roomNumber[slot] << endl;
+    cout << "Room Type: " << table.typeNames[table.typeId[slot]] << endl;
+    cout << "Price Per Day: Rs:" << table.pricePerDay[slot] << endl;
     cout << "\033[38;5;214mAmenities:" << endl;
-    for (size_t i = 0; i < room.amenities.size(); ++i) {
-        cout << i + 1 << ". \033[0m" << room.amenities[i] << endl;
+    int number = 1;
+    for (size_t i = 0; i < table.amenityNames.size(); ++i) {
+        if (table.amenities[slot] & (1u << i)) {
+            cout << number++ << ". \033[0m\033[38;5;214m" << table.amenityNames[i] << "\033[0m" << endl;
+        }
     }
 
     cout << "\033[38;5;129m*************************************************\033[0m" << endl;
 }
 
+// ---------------------------------------------------------------------------
+// Room inventory index
+//
+// Finds a room by its number without scanning the rooms, and keeps one bitset of
+// free rooms per room type (bit i set = the room at position i is free). The first
+// free room of a type is found 64 rooms per word, and the number of free rooms of
+// a type is kept in a counter. The index must be told whenever a room is booked or freed.
+// ---------------------------------------------------------------------------
+
+const size_t kNoRoom = (size_t)-1;
+
+struct RoomInventory {
+    unordered_map<int, size_t> slotByNumber; // Room number -> position in the room table
+    vector<vector<uint64_t> > freeBits;      // Room type id -> bitset of free positions
+    vector<int> freeCount;                   // Room type id -> number of free rooms
+    vector<int> roomCount;                   // Room type id -> number of rooms
+};
+
+// Function to get the id of a room type (-1 if the hotel has no such rooms)
+int roomTypeId(const RoomTable& table, const string& type) {
+    for (size_t i = 0; i < table.typeNames.size(); ++i) {
+        if (table.typeNames[i] == type) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to mark a room as free or booked in the index
+void setRoomFree(RoomInventory& inventory, const RoomTable& table, size_t slot, bool isFree) {
+    int type = table.typeId[slot];
+    uint64_t& word = inventory.freeBits[type][slot / 64];
+    uint64_t mask = 1ULL << (slot % 64);
+    bool wasFree = (word & mask) != 0;
+    if (wasFree == isFree) {
+        return;
+    }
+    if (isFree) {
+        word |= mask;
+        inventory.freeCount[type]++;
+    } else {
+        word &= ~mask;
+        inventory.freeCount[type]--;
+    }
+}
+
+// Function to build the index from the room table
+void buildRoomInventory(RoomInventory& inventory, const RoomTable& table) {
+    size_t count = table.roomNumber.size();
+    inventory = RoomInventory();
+    inventory.slotByNumber.reserve(count);
+    inventory.freeBits.assign(table.typeNames.size(), vector<uint64_t>((count + 63) / 64, 0));
+    inventory.freeCount.assign(table.typeNames.size(), 0);
+    inventory.roomCount.assign(table.typeNames.size(), 0);
+    for (size_t i = 0; i < count; ++i) {
+        inventory.slotByNumber[table.roomNumber[i]] = i;
+        inventory.roomCount[table.typeId[i]]++;
+        setRoomFree(inventory, table, i, !table.isBooked[i]);
+    }
+}
+
+// Function to find the position of a room by its number (kNoRoom if it does not exist)
+size_t findRoomSlot(const RoomInventory& inventory, int roomNumber) {
+    unordered_map<int, size_t>::const_iterator found = inventory.slotByNumber.find(roomNumber);
+    return (found == inventory.slotByNumber.end()) ? kNoRoom : found->second;
+}
+
+// Function to find the first free room of a type (kNoRoom if all are booked)
+size_t firstFreeRoom(const RoomInventory& inventory, int type) {
+    if (type < 0 || inventory.freeCount[type] == 0) {
+        return kNoRoom;
+    }
+    const vector<uint64_t>& bits = inventory.freeBits[type];
+    for (size_t w = 0; w < bits.size(); ++w) {
+        if (bits[w] != 0) {
+            return w * 64 + __builtin_ctzll(bits[w]);
+        }
+    }
+    return kNoRoom;
+}
+
+// Function to count the free rooms of a type
+int countFreeRooms(const RoomInventory& inventory, int type) {
+    return (type < 0) ? 0 : inventory.freeCount[type];
+}
+
 // Function to display all rooms
-void displayRooms(const vector<Room>& rooms) {
+void displayRooms(const RoomTable& table, const RoomInventory& inventory) {
     cout << "\n\033[38;5;223mRoom Availability:\033[0m" << endl;
-    for (size_t i = 0; i < rooms.size(); ++i) {
+    for (size_t i = 0; i < table.roomNumber.size(); ++i) {
         if (i % 10 == 0) cout << endl; // New row every 10 rooms
-        cout << "|Room" << setw(3) << rooms[i].roomNumber;
-        cout << (rooms[i].isBooked ? "\033[31m(Booked)\033[0m| " : "\033[32m(Free)\033[0m| ");
+        cout << "|Room" << setw(3) << table.roomNumber[i];
+        cout << (table.isBooked[i] ? "\033[31m(Booked)\033[0m| " : "\033[32m(Free)\033[0m| ");
     }
     cout << endl;
 
+    // Free rooms per type, straight from the inventory counters
+    cout << "\n\033[38;5;223mFree rooms:\033[0m";
+    for (size_t type = 0; type < table.typeNames.size(); ++type) {
+        cout << " " << table.typeNames[type] << " \033[32m" << countFreeRooms(inventory, type) << "\033[0m";
+    }
+    cout << endl;
 }
 
-// Function to update check-in time in the file
-void updateCheckInTime(const string& filename, int roomNumber, const string& checkInTime) {
-    ifstream file(filename);
-    vector<string> lines;
-    bool entryUpdated = false;
-
-    if (file.is_open()) {
-        string line;
-
-        while (getline(file, line)) {
-            string name, roomNo, checkIn, checkOut, contactNumber, emailAddress, numberOfDays;
-
-            stringstream ss(line);
-            getline(ss, name, ',');
-            getline(ss, roomNo, ',');
-            getline(ss, checkIn, ',');
-            getline(ss, checkOut, ',');
-            getline(ss, contactNumber, ',');
-            getline(ss, emailAddress, ',');
-            getline(ss, numberOfDays, ',');
-
-            if (to_string(roomNumber) == roomNo) {
-                checkIn = checkInTime;
-                ostringstream updatedLine;
-                updatedLine << name << "," << roomNo << "," << checkIn << "," << checkOut << "," << contactNumber << "," << emailAddress << "," << numberOfDays;
-                lines.push_back(updatedLine.str());
-                entryUpdated = true;
-            } else {
-                lines.push_back(line);
-            }
+// ---------------------------------------------------------------------------
+// Operation timings
+//
+// Each front-desk operation, journal write and report is counted and its latency
+// added to a histogram with one bucket per power of two nanoseconds. The counters
+// are relaxed atomics, so timing costs two clock reads and a few increments, and
+// the threads of the hotel service can record at the same time. Menu option 9
+// shows the timings, batch mode prints them to stderr when it ends, and --bench
+// writes them as JSON.
+// ---------------------------------------------------------------------------
+
+enum HotelOperation {
+    kOpOpenStore,
+    kOpBookRoom,
+    kOpCheckInRoom,
+    kOpCheckOutRoom,
+    kOpUpdateCheckInTime,
+    kOpUpdateCheckOutTime,
+    kOpJournalSync,
+    kOpCompaction,
+    kOpCustomerReportPage,
+    kOpSummaryReport,
+    kOperationCount
+};
+const char* const kOperationNames[kOperationCount] = { "openCustomerStore", "bookRoom", "checkInRoom", "checkOutRoom",
+                                                       "updateCheckInTime", "updateCheckOutTime", "journalSync",
+                                                       "compaction", "customerReportPage", "summaryReport" };
+const int kLatencyBuckets = 48; // Bucket b counts latencies from 2^b up to 2^(b+1) ns; the last one also takes longer ones
+
+// Count and latency histogram of one kind of operation
+struct OperationStats {
+    atomic<uint64_t> count;
+    atomic<uint64_t> totalNanos;
+    atomic<uint64_t> maxNanos;
+    atomic<uint64_t> buckets[kLatencyBuckets];
+
+    OperationStats() : count(0), totalNanos(0), maxNanos(0) {
+        for (int i = 0; i < kLatencyBuckets; ++i) {
+            buckets[i] = 0;
         }
-        file.close();
     }
-
-    if (!entryUpdated) {
-        cout << "\033[31mError: Room number not found in the file.\033[0m" << endl;
-        return;
+};
+
+// Function to add one operation's latency to its statistics
+void recordOperation(OperationStats& stats, uint64_t nanos) {
+    int bucket = (nanos == 0) ? 0 : min(63 - __builtin_clzll(nanos), kLatencyBuckets - 1);
+    stats.buckets[bucket].fetch_add(1, memory_order_relaxed);
+    stats.count.fetch_add(1, memory_order_relaxed);
+    stats.totalNanos.fetch_add(nanos, memory_order_relaxed);
+    uint64_t longest = stats.maxNanos.load(memory_order_relaxed);
+    while (nanos > longest && !stats.maxNanos.compare_exchange_weak(longest, nanos, memory_order_relaxed)) {
     }
+}
 
-    ofstream outFile(filename, ios::trunc);
-    if (outFile.is_open()) {
-        for (size_t i = 0; i < lines.size(); ++i) {
-            const string& updatedLine = lines[i];
+// Times an operation from its construction to the end of the enclosing scope
+struct OperationTimer {
+    OperationStats& stats;
+    chrono::steady_clock::time_point start;
 
-            outFile << updatedLine << "\n";
+    explicit OperationTimer(OperationStats& operationStats) : stats(operationStats), start(chrono::steady_clock::now()) {}
+    ~OperationTimer() {
+        recordOperation(stats, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    }
+};
+
+// Function to estimate a latency percentile (0-100) from the histogram, interpolating
+// inside the bucket it falls in; never more than the longest latency seen
+uint64_t latencyPercentile(const OperationStats& stats, double percentile) {
+    uint64_t count = stats.count.load(memory_order_relaxed);
+    if (count == 0) {
+        return 0;
+    }
+    double rank = max(percentile / 100 * count, 1.0);
+    uint64_t before = 0;
+    for (int b = 0; b < kLatencyBuckets; ++b) {
+        uint64_t inBucket = stats.buckets[b].load(memory_order_relaxed);
+        if (inBucket != 0 && before + inBucket >= rank) {
+            double low = (b == 0) ? 0 : (double)(1ULL << b);
+            double estimate = low + (double)(1ULL << b) * (rank - before) / inBucket;
+            return min((uint64_t)estimate, stats.maxNanos.load(memory_order_relaxed));
         }
-        outFile.close();
-        
-    } else {
-        cout << "\033[31mError: Could not open file for writing.\033[0m" << endl;
+        before += inBucket;
     }
+    return stats.maxNanos.load(memory_order_relaxed);
 }
 
-// Function to update the checkout time in the file
-void updateCheckOutTime(const string& filename, int roomNumber, const string& checkoutTime) {
-    ifstream file(filename);
-    vector<string> lines;
-    bool entryUpdated = false;
+// Function to format the timings of the operations that ran as a table (times in microseconds)
+string formatOperationTimings(const OperationStats* timings) {
+    ostringstream out;
+    out << left << setw(22) << "Operation" << right << setw(10) << "Count" << setw(12) << "Mean (us)" << setw(12) << "p50 (us)"
+        << setw(12) << "p99 (us)" << setw(12) << "Max (us)" << "\n" << fixed << setprecision(1);
+    for (int op = 0; op < kOperationCount; ++op) {
+        const OperationStats& stats = timings[op];
+        uint64_t count = stats.count.load(memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        out << left << setw(22) << kOperationNames[op] << right << setw(10) << count << setw(12)
+            << stats.totalNanos.load(memory_order_relaxed) / 1000.0 / count << setw(12) << latencyPercentile(stats, 50) / 1000.0
+            << setw(12) << latencyPercentile(stats, 99) / 1000.0 << setw(12) << stats.maxNanos.load(memory_order_relaxed) / 1000.0
+            << "\n";
+    }
+    return out.str();
+}
 
-    if (file.is_open()) {
-        string line;
+// Function to format the timings of every operation as a JSON object (times in nanoseconds)
+string operationTimingsJson(const OperationStats* timings) {
+    ostringstream out;
+    out << "{";
+    for (int op = 0; op < kOperationCount; ++op) {
+        const OperationStats& stats = timings[op];
+        uint64_t count = stats.count.load(memory_order_relaxed);
+        out << (op == 0 ? "\n" : ",\n") << "    \"" << kOperationNames[op] << "\": {\"count\": " << count
+            << ", \"meanNs\": " << (count == 0 ? 0 : stats.totalNanos.load(memory_order_relaxed) / count)
+            << ", \"p50Ns\": " << latencyPercentile(stats, 50) << ", \"p99Ns\": " << latencyPercentile(stats, 99)
+            << ", \"maxNs\": " << stats.maxNanos.load(memory_order_relaxed) << "}";
+    }
+    out << "\n  }";
+    return out.str();
+}
 
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string name, roomNo, checkInTime, checkOutTime, contactNumber, emailAddress, numberOfDays;
-
-            getline(ss, name, ',');
-            getline(ss, roomNo, ',');
-            getline(ss, checkInTime, ',');
-            getline(ss, checkOutTime, ',');
-            getline(ss, contactNumber, ',');
-            getline(ss, emailAddress, ',');
-            getline(ss, numberOfDays, ',');
-
-            if (to_string(roomNumber) == roomNo) {
-                checkOutTime = checkoutTime;
-                ostringstream updatedLine;
-                updatedLine << name << "," << roomNo << "," << checkInTime << "," << checkOutTime << "," << contactNumber << "," << emailAddress << "," << numberOfDays;
-                lines.push_back(updatedLine.str());
-                entryUpdated = true;
-            } else {
-                lines.push_back(line);
-            }
+// ---------------------------------------------------------------------------
+// Customer data storage
+//
+// CustomerData.txt is the ledger of finished stays, one CSV row per stay:
+//     name,roomNo,checkInTime,checkOutTime,contactNumber,emailAddress,numberOfDays
+// Stays that are still open live in CustomerData.journal, an append-only log of
+// booking (B), reservation (R), arrival (A), check-in (I) and check-out (O) records.
+// A booking starts today and occupies its room at once; a reservation starts on a
+// later day and occupies the room when the guest arrives. Every front-desk operation
+// appends a single line to the journal, so its cost does not grow with the ledger.
+// Every record carries a checksum; a torn record left by a crash is cut off on the
+// next start. Compaction appends finished stays to the ledger and then atomically
+// replaces the journal with one that only holds the open bookings.
+//
+// After each compaction the room table is saved to CustomerData.snapshot together
+// with the journal position it covers. On startup the snapshot is loaded and only
+// the journal records written after it are applied to the rooms, so startup never
+// reads the ledger and grows only with the changes made since the last snapshot.
+// The snapshot only restores occupancy and guests: room numbers, types, prices and
+// amenities always come from createRooms(), and a snapshot of another layout is
+// ignored in favour of replaying the journal.
+//
+// CustomerData.idx indexes the ledger for reports: one fixed-size entry per row
+// with its position, room, dates and a hash of the guest name. Compaction appends
+// the entries of the rows it writes; whatever the index lacks is indexed from the
+// ledger when a report starts. CustomerData.keys holds the guest hash, room and
+// first day of every entry, each kind sorted, so a filtered report binary-searches
+// for its rows. Keys are rebuilt by merging once kLedgerTailRows entries are not
+// covered; those are gone through in order. Reports map both files instead of
+// reading them into memory. The snapshot also carries the running report totals
+// (revenue by room type, check-ins, nights), which every check-in updates, so
+// summaries never scan the history. The journal header keeps the totals of the
+// stays already in the ledger, so a lost snapshot only costs a replay of the
+// journal. A ledger written before the totals were kept is counted once, on the
+// first summary report.
+// ---------------------------------------------------------------------------
+
+const size_t kCompactionThreshold = 1024; // Fewest journal records written before the journal is compacted
+const uint32_t kSnapshotMagic = 0x50534d48;  // "HMSP"
+const uint32_t kSnapshotVersion = 4;
+
+// A booking or reservation recorded in the current journal
+struct JournalBooking {
+    int roomNumber;
+    long long offset;    // Byte offset of the booking (B or R) record in the journal
+    int length;          // Length of the booking record, including the newline
+    string checkInTime;
+    string checkOutTime;
+    bool checkedOut;
+    int arrivalDay;      // Day number of the first night
+    int nights;
+    bool active;         // The guest occupies the room (always true for B records)
+};
+
+// One ledger row in CustomerData.idx
+struct LedgerEntry {
+    int64_t offset;      // Where the row starts in the ledger
+    int32_t length;      // Row length, including the newline
+    int32_t roomNumber;
+    int32_t checkInDay;  // -1 if the guest never checked in
+    int32_t checkOutDay; // -1 for a no-show
+    uint32_t guestHash;  // guestNameHash of the guest name
+    int32_t nights;
+};
+static_assert(sizeof(LedgerEntry) == 32, "CustomerData.idx entries are 32 bytes");
+
+// One key of a ledger row in CustomerData.keys
+struct LedgerKey {
+    uint32_t key;
+    uint32_t row;        // Position of the row's entry in CustomerData.idx
+};
+
+enum LedgerKeyKind { kGuestKey, kRoomKey, kDayKey, kLedgerKeyKinds }; // Guest name hash, room number, first day + 1
+
+// Start of CustomerData.keys, followed by one section of keys sorted by (key, row) per kind
+struct LedgerKeyHeader {
+    uint32_t magic;
+    uint32_t rows;          // Index entries covered; every section holds this many keys
+    int64_t coveredBytes;   // End of the last covered row in the ledger
+    int32_t maxStayDays;    // Longest covered stay, for looking up date ranges
+    uint32_t reserved;
+};
+static_assert(sizeof(LedgerKeyHeader) == 24, "CustomerData.keys starts with a 24-byte header");
+
+const uint32_t kLedgerKeyMagic = 0x4b534d48; // "HMSK"
+const size_t kLedgerTailRows = 4096;         // Index entries a report may go through in order before the keys are rebuilt
+
+// The ledger index and its keys, mapped read-only while a report runs
+struct LedgerIndexView {
+    const LedgerEntry* entries;
+    size_t entryCount;
+    const LedgerKey* keys[kLedgerKeyKinds]; // Each covers the first keyRows entries
+    size_t keyRows;
+    int32_t maxStayDays;
+    const char* entryMapping;
+    size_t entryMappingSize;
+    const char* keyMapping;
+    size_t keyMappingSize;
+
+    LedgerIndexView()
+        : entries(NULL), entryCount(0), keyRows(0), maxStayDays(0), entryMapping(NULL), entryMappingSize(0), keyMapping(NULL),
+          keyMappingSize(0) {
+        for (int kind = 0; kind < kLedgerKeyKinds; ++kind) {
+            keys[kind] = NULL;
         }
-        file.close();
     }
+};
+
+// Totals kept up to date by every check-in, for the summary report
+struct ReportTotals {
+    vector<long long> revenueByType; // Rs. billed at check-in, by room type id
+    long long stays;                 // Check-ins
+    long long nights;                // Nights billed at those check-ins
+
+    ReportTotals() : stays(0), nights(0) {}
+};
+
+struct CustomerStore {
+    string ledgerPath;
+    string journalPath;
+    string snapshotPath;
+    string indexPath;
+    string keyPath;
+    RoomTable* rooms;        // Room table saved to the snapshot on compaction
+    int journalFd;
+    long long generation;    // Incremented by every compaction
+    long long ledgerBytes;   // Size of the ledger when the current journal was started
+    long long journalBytes;  // Size of the valid part of the journal
+    long long nextBookingId;
+    int recordsSinceCompaction;
+    bool batching;           // Records are collected in pendingJournal until the batch is committed
+    string pendingJournal;   // Journal lines not yet written (batch mode only)
+    map<long long, JournalBooking> bookings;         // Booking id -> booking, in booking order
+    unordered_map<int, long long> openBookingByRoom; // Room number -> id of its open booking
+    ReportTotals totals;
+    long long uncountedLedgerBytes;                  // The ledger rows before this offset are not in totals yet
+    OperationStats timings[kOperationCount];         // Latencies of the operations on this store
+
+    CustomerStore()
+        : rooms(NULL), journalFd(-1), generation(0), ledgerBytes(0), journalBytes(0), nextBookingId(1), recordsSinceCompaction(0),
+          batching(false), uncountedLedgerBytes(0) {}
+};
+
+// Function to build a file name next to the ledger (e.g. CustomerData.txt -> CustomerData.journal)
+string siblingPath(const string& path, const string& extension) {
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return path + extension;
+    }
+    return path.substr(0, dot) + extension;
+}
 
-    if (!entryUpdated) {
-        cout << "\033[31mError: Room number not found in the file.\033[0m" << endl;
-        return;
+// Function to get the size of a file in bytes (-1 if it does not exist)
+long long fileSize(const string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return -1;
     }
+    return info.st_size;
+}
 
-    ofstream outFile(filename, ios::trunc);
-    if (outFile.is_open()) {
-        for (size_t i = 0; i < lines.size(); ++i) {
-             const string& updatedLine = lines[i];
-            outFile << updatedLine << "\n";
+// Function to write a whole buffer to a file descriptor
+bool writeFully(int fd, const string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
         }
-        outFile.close();
-        
-    } else {
-        cout << "\033[31mError: Could not open file for writing.\033[0m" << endl;
+        written += n;
     }
+    return true;
 }
 
-// Function to book a room
-void bookRoom(vector<Room>& rooms) {
-    int roomNumber;
-    string customerName;
-    string contactNumber;
-    string emailAddress;
-    string numberOfDays;
-    
-    cout << "\033[34mEnter Room Number to Book: ";
-   
+// Function to flush a directory entry so that a rename survives a crash
+void syncParentDirectory(const string& path) {
+    size_t slash = path.find_last_of('/');
+    string directory = (slash == string::npos) ? "." : path.substr(0, slash + 1);
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
 
+// Function to replace a file's contents atomically (write a temporary file, then rename it)
+bool replaceFileAtomically(const string& path, const string& contents) {
+    string tempPath = path + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool written = writeFully(fd, contents) && fsync(fd) == 0;
+    close(fd);
+    if (!written || rename(tempPath.c_str(), path.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    syncParentDirectory(path);
+    return true;
+}
 
-    try {
-        // Error handling for non-integer input
-        if (!(cin >> roomNumber)) {
-            throw invalid_argument("\033[31mInvalid input! Please enter a valid room number (integer).\033[0m");
-        }
+// Function to compute a 32-bit FNV-1a hash, used as a checksum for stored data
+uint32_t fnv1a(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
+// Function to compute the checksum that guards each journal record
+string journalChecksum(const string& payload) {
+    char buffer[9];
+    snprintf(buffer, sizeof(buffer), "%08x", fnv1a(payload.data(), payload.size()));
+    return string(buffer);
+}
 
-    for (size_t i = 0; i < rooms.size(); ++i)
-    {
-        Room& room = rooms[i];
-        if (room.roomNumber == roomNumber) {
-            if (room.isBooked) {
-                cout << "\033[34mRoom " << roomNumber << " is already booked!" << endl;
-            } else {
-                        cout << "\033[38;5;141mEnter Customer Name: ";
-                        while (true) {
-                      try {
-                     cin.ignore(); // Clear input buffer before taking string input
-                         getline(cin, customerName);
-
-                   // Validate customer name: must not be empty and must only contain valid characters
-                   if (customerName.empty()) {
-                  throw invalid_argument("\033[31mCustomer name cannot be empty! Please enter a valid name.\033[0m");
-                  }
-                for (size_t i = 0; i < customerName.size(); ++i) {
-                     char c = customerName[i];
-                    if (!(isalpha(c) || isspace(c) || c == '-')) {
-                 throw invalid_argument("\033[31mInvalid characters in name! Use letters, spaces, or hyphens only.\033[0m");
-             }
-                 }
-
-                  break; // Exit loop if valid
-                  } catch (const invalid_argument& e) {
-                 cout << e.what() << endl;
-              cout << "Please re-enter Customer Name: ";
-                 }
-                }
-                
-            
-             while (true) {
-                        cout << "\033[33mEnter Contact Number: ";
-                        try {
-                            getline(cin, contactNumber);
-
-                            // Validate contact number (digits only, length between 7 and 15)
-                            if (contactNumber.empty() || contactNumber.length() < 7 || contactNumber.length() > 15 ||
-                                !all_of(contactNumber.begin(), contactNumber.end(), ::isdigit)) {
-                                throw invalid_argument("\033[31mInvalid contact number! Enter digits only (7-15 characters).\033[0m");
-                            }
-                            break; // Exit loop if valid
-                        } catch (const invalid_argument& e) {
-                            cout << e.what() << endl;
-                        }
-                    } 
-                        // Enter email with validation
-                        while (true) {
-                        cout << "\033[38;5;111mEnter Email Address: ";
-                         getline(cin, emailAddress);
-
-                             // Check if email contains '@' and '.' in valid positions
-                          size_t atPos = emailAddress.find('@');
-                              size_t dotPos = emailAddress.find('.');
-
-                          if (atPos != string::npos && dotPos != string::npos && atPos < dotPos && dotPos != emailAddress.length() - 1) {
-                             break; // Valid email, exit the loop
-                               } else {
-                              cout << "\033[31mInvalid email address. Please enter a valid email.\033[0m" << endl;
-                              }
-                            }
-
-                // Input validation for number of days (string input)
-                while (true) {
-                    cout << "\033[38;5;45mEnter Number of Days for Stay: ";
-                    getline(cin, numberOfDays); // Keep as string input
-
-                    // Validate if numberOfDays contains only digits and is a positive integer
-                    if (all_of(numberOfDays.begin(), numberOfDays.end(), ::isdigit) && !numberOfDays.empty()) {
-                        // Valid input, break out of the loop
-                        break;
-                    } else {
-                        cout << "\033[31mInvalid input! Enter a valid positive integer.\033[0m" << endl;
-                    }
-                }
-                             // Inside the bookRoom function after gathering other details:
-                            while (true) {
-                         cout << "\033[38;5;141mEnter Payment Method (Cash/Credit): ";
-                     getline(cin, room.paymentMethod);  // Read the payment method
-
-                              // Validate payment method
-                       if (room.paymentMethod == "Cash" || room.paymentMethod == "Credit") {
-                          break;  // Valid input, exit the loop
-                       } else {
-                       cout << "\033[31mInvalid payment method. Please enter 'Cash' or 'Credit'.\033[0m" << endl;
-                     }
-}
-
-                room.isBooked = true;
-                room.customerName = customerName;
-                room.contactNumber = contactNumber;  // Store the contact number
-                room.emailAddress = emailAddress;    // Store the email address
-                room.numberOfDays = numberOfDays;    
-                room.checkInTime = "";
-                cout << "\033[32mRoom " << roomNumber << " has been booked successfully!\033[0m" << endl;
-
-                // Save booking details
-                ofstream file("CustomerData.txt", ios::app);
-                if (file.is_open()) {
-                    
-                    file << customerName << "," << roomNumber << "," << room.checkInTime << "," << room.checkOutTime << "," << contactNumber << "," << emailAddress << "," << numberOfDays  << "\n";
-                    file.close();
-                } else {
-                    cout << "\033[31mError: Could not open file!\033[0m" << endl;
-                }
-            }
-            return;
-        }
+// Function to turn a record into a journal line: payload,checksum\n
+string journalLine(const string& payload) {
+    return payload + "," + journalChecksum(payload) + "\n";
+}
+
+// Function to check a journal line (without its newline) and strip the checksum from it
+bool verifyJournalLine(string_view line, string_view& payload) {
+    if (line.size() < 10 || line[line.size() - 9] != ',') {
+        return false;
     }
-    cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
+    payload = line.substr(0, line.size() - 9);
+    uint32_t checksum;
+    string_view hex = line.substr(line.size() - 8);
+    from_chars_result result = from_chars(hex.data(), hex.data() + hex.size(), checksum, 16);
+    return result.ec == errc() && result.ptr == hex.data() + hex.size() && checksum == fnv1a(payload.data(), payload.size());
 }
-   catch (const invalid_argument& e) {
-        cout << e.what() << endl;
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+// Function to read the payload of a booking record back from the journal
+bool readBookingRecord(const CustomerStore& store, const JournalBooking& booking, string& payload) {
+    string line(booking.length, '\0');
+    long long pendingStart = store.journalBytes - store.pendingJournal.size();
+    if (booking.offset >= pendingStart) {
+        // Written in the current batch, not on disk yet
+        line = store.pendingJournal.substr(booking.offset - pendingStart, booking.length);
+    } else if (pread(store.journalFd, &line[0], line.size(), booking.offset) != (ssize_t)line.size()) {
+        return false;
     }
-    catch (const runtime_error& e) {
-        cout << e.what() << endl;
+    string_view verified;
+    if (!verifyJournalLine(string_view(line).substr(0, line.size() - 1), verified)) { // Without the newline
+        return false;
     }
+    payload = string(verified);
+    return true;
 }
 
-// Function to validate email (move this outside of displayCustomerDetails)
-bool isValidEmail(const string& emailAddress) {
-    const regex email_regex("^[\\w-]+(\\.[\\w-]+)*@[a-zA-Z0-9-]+(\\.[a-zA-Z]{2,})+$");
-    return regex_match(emailAddress, email_regex);
+// Function to hash a guest name the same way whatever its letter case
+uint32_t guestNameHash(string_view name) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < name.size(); ++i) {
+        hash ^= (unsigned char)tolower((unsigned char)name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
+// Function to describe one ledger row (without its newline) as an index entry
+LedgerEntry ledgerEntryFromRow(string_view row, long long offset) {
+    // name,roomNo,checkInTime,checkOutTime,contactNumber,emailAddress,numberOfDays
+    string_view fields[kMaxFields];
+    size_t fieldCount = tokenizeFields(row, fields, kMaxFields);
+    for (size_t i = fieldCount; i < 7; ++i) {
+        fields[i] = string_view();
+    }
+    LedgerEntry entry = { offset, (int32_t)row.size() + 1, (int32_t)fieldNumber(fields[1]), -1, -1, guestNameHash(fields[0]),
+                          (int32_t)fieldNumber(fields[6]) };
+    int day;
+    if (fields[2].size() >= 10 && parseDay(fields[2].substr(0, 10), day)) {
+        entry.checkInDay = day;
+    }
+    if (fields[3].size() >= 10 && parseDay(fields[3].substr(0, 10), day)) {
+        entry.checkOutDay = day;
+    }
+    return entry;
+}
 
-/*void clearFileAndAddNewData(const std::string& filename)
- {
-    // Open the file in write mode with truncation (this clears the file)
-    std::ofstream file(filename, std::ios::trunc);
+// Function to index the whole rows in a block of ledger text that starts at the given offset.
+// Returns the number of bytes indexed (a row without its newline is left out).
+size_t indexLedgerRows(string_view rows, long long offset, vector<LedgerEntry>& entries) {
+    size_t start = 0;
+    while (start < rows.size()) {
+        const char* newline = static_cast<const char*>(memchr(rows.data() + start, '\n', rows.size() - start));
+        if (newline == NULL) {
+            break;
+        }
+        size_t end = newline - rows.data();
+        entries.push_back(ledgerEntryFromRow(rows.substr(start, end - start), offset + start));
+        start = end + 1;
+    }
+    return start;
+}
 
-    if (file.is_open()) {
-        // Now the file is empty. You can start adding new data.
-       
+// Function to read entries from the ledger index file
+bool readLedgerEntries(int fd, size_t first, size_t count, LedgerEntry* entries) {
+    ssize_t bytes = count * sizeof(LedgerEntry);
+    return pread(fd, entries, bytes, first * sizeof(LedgerEntry)) == bytes;
+}
 
-        // Close the file after adding new data
-        file.close();
-    } else {
-        std::cerr  << std::endl;
+// Function to count the entries at the start of the index that describe rows within the ledger.
+// Entries are in ledger order, so a torn entry or one cut off by recovery can only be at the end.
+size_t validLedgerEntries(int fd, long long ledgerBytes) {
+    struct stat info;
+    size_t count = (fstat(fd, &info) == 0) ? info.st_size / sizeof(LedgerEntry) : 0;
+    LedgerEntry last;
+    if (count == 0 || (readLedgerEntries(fd, count - 1, 1, &last) && last.offset + last.length <= ledgerBytes)) {
+        return count;
     }
- }
- */
+    size_t low = 0, high = count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        LedgerEntry entry;
+        if (readLedgerEntries(fd, middle, 1, &entry) && entry.offset + entry.length <= ledgerBytes) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
 
+// Function to cut the index file down to its valid entries; returns false if it could not be truncated
+bool truncateLedgerIndex(int fd, const string& path, size_t count) {
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size != (off_t)(count * sizeof(LedgerEntry)) &&
+        ftruncate(fd, count * sizeof(LedgerEntry)) != 0) {
+        cout << "\033[31mError: Could not truncate " << path << ".\033[0m" << endl;
+        return false;
+    }
+    return true;
+}
 
-// Function to display customer details
-void displayCustomerDetails() {
-    
-    ifstream file("CustomerData.txt");
-    string line;
-    cout << "\033[38;5;111mCustomer Details:" << endl;
-    cout << "-----------------------------------------------------------------------------------------------------------------------------------------------------------------" << endl;
-     cout << setw(20) << "Customer Name" << setw(13) << "Room No" << setw(21) << "Check-in Time" << setw(27) << "Check-out Time"<< setw(26) << "Contact Number"
-         << setw(26) << "Email Address" << setw(20) << "Days Stay" << endl;
-    cout << "------------------------------------------------------------------------------------------------------------------------------------------------------------------\033[0m" << endl;
-    if (file.is_open()) {
-        while (getline(file, line)) {
-            size_t pos1 = line.find(',');
-            size_t pos2 = line.find(',', pos1 + 1);
-            size_t pos3 = line.find(',', pos2 + 1);
-            size_t pos4 = line.find(',', pos3 + 1);
-            size_t pos5 = line.find(',', pos4 + 1);
-            size_t pos6 = line.find(',', pos5 + 1);
-          
-
-            // Extract the fields using substrings
-            string name =  "\033[33m" + line.substr(0, pos1)+ "\033[0m";                          // Field 1
-             string roomNo = line.substr(pos1 + 1, pos2 - pos1 - 1);      // Field 2
-            string checkInTime =  line.substr(pos2 + 1, pos3 - pos2 - 1); // Field 3
-            string checkOutTime =  line.substr(pos3 + 1, pos4 - pos3 - 1) ;  // Field 4
-            if (checkOutTime == "-") {
-                checkOutTime = "\033[31m\t\tNot Checked Out\033[0m";  // Mark rooms not checked out
-            }
-            string contactNumber = "\033[32m" + line.substr(pos4 + 1, pos5 - pos4 - 1)+ "\033[0m";  // Field 5
-            string emailAddress = "\033[34m" + line.substr(pos5 + 1, pos6 - pos5 - 1) + "\033[0m" ;       // Field 6
-            string numberOfDays = "\033[35m" + ((pos6 != string::npos) ? line.substr(pos6 + 1) : "") + "\033[0m";
+// Function to drop index entries for ledger rows that recovery cut off (or a torn entry),
+// so the index never describes more than the ledger holds
+void trimLedgerIndex(const CustomerStore& store) {
+    int fd = open(store.indexPath.c_str(), O_RDWR);
+    if (fd < 0) {
+        return;
+    }
+    truncateLedgerIndex(fd, store.indexPath, validLedgerEntries(fd, store.ledgerBytes));
+    close(fd);
+}
 
+// Function to add the entries of rows just appended to the ledger to the index.
+// The file is only extended if it ends exactly where these rows start; otherwise the
+// missing part is indexed from the ledger by updateLedgerIndex. No fsync: the index can
+// always be rebuilt from the ledger.
+void appendLedgerIndex(const CustomerStore& store, const string& rows, long long offset) {
+    vector<LedgerEntry> entries;
+    indexLedgerRows(rows, offset, entries);
+    int fd = open(store.indexPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    size_t count = (fstat(fd, &info) == 0) ? info.st_size / sizeof(LedgerEntry) : 0;
+    LedgerEntry last;
+    bool endsHere = (count == 0) ? offset == 0
+                                 : readLedgerEntries(fd, count - 1, 1, &last) && last.offset + last.length == offset;
+    if (endsHere && (off_t)(count * sizeof(LedgerEntry)) == info.st_size) {
+        string data(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(LedgerEntry));
+        if (lseek(fd, 0, SEEK_END) < 0 || !writeFully(fd, data)) {
+            // A partly written entry is dropped by the next update
+            cout << "\033[31mError: Could not write to " << store.indexPath << ".\033[0m" << endl;
+        }
+    }
+    close(fd);
+}
 
-            // Print formatted data
-            cout << setw(25) << name << setw(15) << roomNo << setw(25) << checkInTime << setw(27) << checkOutTime 
-            << setw(31) << contactNumber << setw(36) <<  emailAddress 
-            << setw(27) << numberOfDays  << endl;
+// Function to bring the ledger index up to date, indexing the ledger rows it is missing
+bool updateLedgerIndex(const CustomerStore& store) {
+    int fd = open(store.indexPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        cout << "\033[31mError: Could not open " << store.indexPath << ".\033[0m" << endl;
+        return false;
+    }
+    size_t count = validLedgerEntries(fd, store.ledgerBytes);
+    LedgerEntry last;
+    if (count > 0 && !readLedgerEntries(fd, count - 1, 1, &last)) {
+        count = 0;
+    }
+    long long indexedBytes = (count > 0) ? last.offset + last.length : 0;
+    bool updated = truncateLedgerIndex(fd, store.indexPath, count);
+
+    // The ledger is read 4 MB at a time; each read starts at the first row not yet indexed
+    int ledgerFd = (updated && indexedBytes < store.ledgerBytes) ? open(store.ledgerPath.c_str(), O_RDONLY) : -1;
+    string rows;
+    vector<LedgerEntry> entries;
+    while (ledgerFd >= 0 && indexedBytes < store.ledgerBytes) {
+        rows.resize(min(store.ledgerBytes - indexedBytes, 4LL << 20));
+        ssize_t got = pread(ledgerFd, &rows[0], rows.size(), indexedBytes);
+        entries.clear();
+        size_t indexed = (got > 0) ? indexLedgerRows(string_view(rows.data(), got), indexedBytes, entries) : 0;
+        if (indexed == 0) {
+            break;
+        }
+        ssize_t bytes = entries.size() * sizeof(LedgerEntry);
+        if (pwrite(fd, entries.data(), bytes, count * sizeof(LedgerEntry)) != bytes) {
+            cout << "\033[31mError: Could not write to " << store.indexPath << ".\033[0m" << endl;
+            updated = false;
+            break;
+        }
+        count += entries.size();
+        indexedBytes += indexed;
+    }
+    if (ledgerFd >= 0) {
+        close(ledgerFd);
+    }
+    close(fd);
+    return updated;
+}
+
+// Function to get the first and last day of a ledger row's stay (-1 if not known)
+int stayFirstDay(const LedgerEntry& entry) {
+    return (entry.checkInDay >= 0) ? entry.checkInDay : entry.checkOutDay;
+}
+
+int stayLastDay(const LedgerEntry& entry) {
+    return (entry.checkOutDay >= 0) ? entry.checkOutDay : entry.checkInDay;
+}
+
+// Function to get a ledger row's key of one kind
+uint32_t ledgerKey(const LedgerEntry& entry, int kind) {
+    if (kind == kGuestKey) {
+        return entry.guestHash;
+    }
+    if (kind == kRoomKey) {
+        return (uint32_t)entry.roomNumber;
+    }
+    return (uint32_t)(stayFirstDay(entry) + 1); // 0 for a no-show
+}
+
+// Function to order ledger keys by key, then by row
+bool ledgerKeyBefore(const LedgerKey& a, const LedgerKey& b) {
+    return a.key != b.key ? a.key < b.key : a.row < b.row;
+}
+
+// Function to map a whole file read-only (NULL if it is missing or empty)
+const char* mapWholeFile(const string& path, size_t& size) {
+    size = 0;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    void* mapping = (fstat(fd, &info) == 0 && info.st_size > 0)
+                        ? mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    size = info.st_size;
+    return static_cast<const char*>(mapping);
+}
+
+// Function to unmap the files of a ledger index view
+void closeLedgerIndexView(LedgerIndexView& view) {
+    if (view.entryMapping != NULL) {
+        munmap(const_cast<char*>(view.entryMapping), view.entryMappingSize);
+    }
+    if (view.keyMapping != NULL) {
+        munmap(const_cast<char*>(view.keyMapping), view.keyMappingSize);
+    }
+    view = LedgerIndexView();
+}
+
+// Function to map the ledger index and its keys. Keys that do not match the index
+// (a ledger cut short by recovery, or a damaged file) are left out.
+void mapLedgerIndexView(const CustomerStore& store, LedgerIndexView& view) {
+    closeLedgerIndexView(view);
+    view.entryMapping = mapWholeFile(store.indexPath, view.entryMappingSize);
+    view.entries = reinterpret_cast<const LedgerEntry*>(view.entryMapping);
+    view.entryCount = view.entryMappingSize / sizeof(LedgerEntry);
+
+    view.keyMapping = mapWholeFile(store.keyPath, view.keyMappingSize);
+    LedgerKeyHeader header;
+    bool valid = view.keyMapping != NULL && view.keyMappingSize >= sizeof(header);
+    if (valid) {
+        memcpy(&header, view.keyMapping, sizeof(header));
+        valid = header.magic == kLedgerKeyMagic && header.rows <= view.entryCount &&
+                view.keyMappingSize == sizeof(header) + (size_t)kLedgerKeyKinds * header.rows * sizeof(LedgerKey) &&
+                (header.rows == 0 ? header.coveredBytes == 0
+                                  : view.entries[header.rows - 1].offset + view.entries[header.rows - 1].length == header.coveredBytes);
+    }
+    if (!valid) {
+        if (view.keyMapping != NULL) {
+            munmap(const_cast<char*>(view.keyMapping), view.keyMappingSize);
+        }
+        view.keyMapping = NULL;
+        view.keyMappingSize = 0;
+        return;
+    }
+    view.keyRows = header.rows;
+    view.maxStayDays = header.maxStayDays;
+    for (int kind = 0; kind < kLedgerKeyKinds; ++kind) {
+        view.keys[kind] = reinterpret_cast<const LedgerKey*>(view.keyMapping + sizeof(header)) + (size_t)kind * header.rows;
+    }
+}
+
+// Function to rewrite CustomerData.keys so it covers every index entry. For each kind of key,
+// the keys already sorted are merged with the sorted keys of the entries added since.
+bool rebuildLedgerKeys(const CustomerStore& store, const LedgerIndexView& view) {
+    LedgerKeyHeader header = { kLedgerKeyMagic, (uint32_t)view.entryCount, 0, view.maxStayDays, 0 };
+    if (view.entryCount > 0) {
+        header.coveredBytes = view.entries[view.entryCount - 1].offset + view.entries[view.entryCount - 1].length;
+    }
+    for (size_t row = view.keyRows; row < view.entryCount; ++row) {
+        const LedgerEntry& entry = view.entries[row];
+        if (entry.checkInDay >= 0 && entry.checkOutDay >= 0) {
+            header.maxStayDays = max(header.maxStayDays, entry.checkOutDay - entry.checkInDay);
+        }
+    }
+
+    string tempPath = store.keyPath + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+    bool written = true;
+    vector<LedgerKey> added;
+    for (int kind = 0; kind < kLedgerKeyKinds && written; ++kind) {
+        added.clear();
+        for (size_t row = view.keyRows; row < view.entryCount; ++row) {
+            LedgerKey key = { ledgerKey(view.entries[row], kind), (uint32_t)row };
+            added.push_back(key);
+        }
+        sort(added.begin(), added.end(), ledgerKeyBefore);
+        const LedgerKey* old = view.keys[kind];
+        size_t i = 0, j = 0;
+        while ((i < view.keyRows || j < added.size()) && written) {
+            const LedgerKey& next = (j == added.size() || (i < view.keyRows && ledgerKeyBefore(old[i], added[j]))) ? old[i++] : added[j++];
+            buffer.append(reinterpret_cast<const char*>(&next), sizeof(next));
+            if (buffer.size() >= (1 << 20)) {
+                written = writeFully(fd, buffer);
+                buffer.clear();
+            }
+        }
+    }
+    written = written && writeFully(fd, buffer) && fsync(fd) == 0;
+    close(fd);
+    if (!written || rename(tempPath.c_str(), store.keyPath.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        cout << "\033[31mError: Could not write " << store.keyPath << ".\033[0m" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to open the ledger index for a report: the ledger rows it lacks are indexed
+// first, and the keys are rebuilt once too many entries are not covered by them
+bool openLedgerIndexView(const CustomerStore& store, LedgerIndexView& view) {
+    if (!updateLedgerIndex(store)) {
+        return false;
+    }
+    mapLedgerIndexView(store, view);
+    if (view.entryCount - view.keyRows > kLedgerTailRows && rebuildLedgerKeys(store, view)) {
+        mapLedgerIndexView(store, view);
+    }
+    return true;
+}
+
+// Function to add a check-in to the running totals (or take it off again with count = -1)
+void countCheckIn(ReportTotals& totals, const RoomTable& table, size_t slot, int nights, int count = 1) {
+    if (totals.revenueByType.size() < table.typeNames.size()) {
+        totals.revenueByType.resize(table.typeNames.size(), 0);
+    }
+    totals.revenueByType[table.typeId[slot]] += count * (long long)table.pricePerDay[slot] * nights;
+    totals.stays += count;
+    totals.nights += count * (long long)nights;
+}
+
+// Function to add the check-ins of the ledger rows written before the totals were kept
+// (a ledger from an older version) to the running totals. Done once, on the first summary.
+void countLedgerCheckIns(CustomerStore& store, const RoomInventory& inventory) {
+    if (!updateLedgerIndex(store)) {
+        return;
+    }
+    LedgerIndexView view;
+    mapLedgerIndexView(store, view);
+    for (size_t i = 0; i < view.entryCount && view.entries[i].offset < store.uncountedLedgerBytes; ++i) {
+        const LedgerEntry& entry = view.entries[i];
+        size_t slot = findRoomSlot(inventory, entry.roomNumber);
+        if (entry.checkInDay >= 0 && slot != kNoRoom) {
+            countCheckIn(store.totals, *store.rooms, slot, entry.nights);
+        }
+    }
+    closeLedgerIndexView(view);
+    store.uncountedLedgerBytes = 0; // Saved by the next compaction
+}
+
+// Function to write report totals as journal header fields: stays,nights,revenue;revenue;...
+string formatReportTotals(const ReportTotals& totals) {
+    string text = to_string(totals.stays) + "," + to_string(totals.nights) + ",";
+    for (size_t type = 0; type < totals.revenueByType.size(); ++type) {
+        text += (type == 0 ? "" : ";") + to_string(totals.revenueByType[type]);
+    }
+    return text;
+}
+
+// Function to read report totals back from the fields written by formatReportTotals
+void parseReportTotals(string_view stays, string_view nights, string_view revenue, ReportTotals& totals) {
+    totals = ReportTotals();
+    totals.stays = fieldNumber(stays);
+    totals.nights = fieldNumber(nights);
+    while (!revenue.empty()) {
+        size_t semicolon = revenue.find(';');
+        totals.revenueByType.push_back(fieldNumber(revenue.substr(0, semicolon)));
+        revenue = (semicolon == string_view::npos) ? string_view() : revenue.substr(semicolon + 1);
+    }
+}
+
+// Function to apply one journal record to the in-memory index
+bool applyJournalRecord(CustomerStore& store, string_view payload, long long offset, int length) {
+    string_view fields[kMaxFields];
+    size_t fieldCount = tokenizeFields(payload, fields, kMaxFields);
+    if (fieldCount < 3) {
+        return false;
+    }
+    long long bookingId = fieldNumber(fields[1]);
+    int roomNumber = fieldNumber(fields[2]);
+
+    // B/R,id,room,name,contact,email,days,payment,arrivalDay (older B records have no arrival day)
+    if ((fields[0] == "B" || fields[0] == "R") && (fieldCount == 9 || (fields[0] == "B" && fieldCount == 8))) {
+        int arrivalDay = (fieldCount == 9) ? fieldNumber(fields[8]) : currentDay();
+        JournalBooking booking = { roomNumber, offset, length, "", "", false, arrivalDay,
+                                   max((int)fieldNumber(fields[6]), 1), fields[0] == "B" };
+        store.bookings[bookingId] = booking;
+        if (booking.active) {
+            store.openBookingByRoom[roomNumber] = bookingId;
+        }
+        store.nextBookingId = max(store.nextBookingId, bookingId + 1);
+        return true;
+    }
+
+    map<long long, JournalBooking>::iterator it = store.bookings.find(bookingId);
+    if (it == store.bookings.end()) {
+        return false;
+    }
+    if (fields[0] == "A" && fieldCount == 3) {
+        it->second.active = true;
+        store.openBookingByRoom[roomNumber] = bookingId;
+        return true;
+    }
+    if (fieldCount != 4) {
+        return false;
+    }
+    if (fields[0] == "I") {
+        it->second.checkInTime = string(fields[3]);
+        return true;
+    }
+    if (fields[0] == "O") {
+        it->second.checkOutTime = string(fields[3]);
+        it->second.checkedOut = true;
+        unordered_map<int, long long>::iterator open = store.openBookingByRoom.find(roomNumber);
+        if (open != store.openBookingByRoom.end() && open->second == bookingId) {
+            store.openBookingByRoom.erase(open);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Function to rebuild a booking request from the fields of a B or R record
+BookingRequest bookingFromRecord(const string_view* fields, const JournalBooking& booking) {
+    BookingRequest request = { booking.roomNumber, string(fields[3]), string(fields[4]), string(fields[5]),
+                               string(fields[6]), string(fields[7]), booking.arrivalDay };
+    return request;
+}
+
+// Function to apply one journal record to the room table (used when replaying on startup).
+// An arrival (A) record refers back to its reservation, which is read from the mapped journal.
+void applyRoomRecord(RoomTable& table, const unordered_map<int, size_t>& roomIndex, CustomerStore& store,
+                     const char* journalData, string_view payload) {
+    string_view fields[kMaxFields];
+    tokenizeFields(payload, fields, kMaxFields); // applyJournalRecord has checked the record
+    unordered_map<int, size_t>::const_iterator found = roomIndex.find(fieldNumber(fields[2]));
+    if (found == roomIndex.end()) {
+        return;
+    }
+    size_t slot = found->second;
+    const JournalBooking& booking = store.bookings.find(fieldNumber(fields[1]))->second;
+
+    if (fields[0] == "B") {
+        occupyRoom(table, slot, bookingFromRecord(fields, booking));
+    } else if (fields[0] == "A") {
+        string_view reservation;
+        string_view reservationFields[kMaxFields];
+        if (verifyJournalLine(string_view(journalData + booking.offset, booking.length - 1), reservation) &&
+            tokenizeFields(reservation, reservationFields, kMaxFields) == 9) {
+            occupyRoom(table, slot, bookingFromRecord(reservationFields, booking));
+        }
+    } else if (fields[0] == "I") {
+        setRoomText(table, table.guest[slot].checkInTime, fields[3]);
+        countCheckIn(store.totals, table, slot, booking.nights);
+    } else if (fields[0] == "O") {
+        table.isBooked[slot] = 0;
+        clearRoomGuest(table, slot);
+    }
+}
+
+// Functions to write values into a binary snapshot
+template <typename T>
+void appendBinary(string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendBinaryString(string& out, const string& value) {
+    appendBinary(out, (uint32_t)value.size());
+    out += value;
+}
+
+// Reads values back from a binary snapshot, failing once it runs past the end
+struct SnapshotReader {
+    const char* data;
+    size_t size;
+    size_t position;
+
+    template <typename T>
+    bool read(T& value) {
+        if (size - position < sizeof(value)) return false;
+        memcpy(&value, data + position, sizeof(value));
+        position += sizeof(value);
+        return true;
+    }
+
+    bool readString(string& value) {
+        uint32_t length;
+        if (!read(length) || size - position < length) return false;
+        value.assign(data + position, length);
+        position += length;
+        return true;
+    }
+
+    template <typename T>
+    bool readColumn(vector<T>& column, size_t count) {
+        if ((size - position) / sizeof(T) < count) return false;
+        column.resize(count);
+        memcpy(column.data(), data + position, count * sizeof(T));
+        position += count * sizeof(T);
+        return true;
+    }
+};
+
+// Function to write a column of the room table into a binary snapshot
+template <typename T>
+void appendColumn(string& out, const vector<T>& column) {
+    out.append(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+}
+
+// Function to save the room table and the journal position it covers
+bool saveRoomSnapshot(const CustomerStore& store) {
+    RoomTable& table = *store.rooms;
+    compactArena(table);
+
+    string data;
+    appendBinary(data, kSnapshotMagic);
+    appendBinary(data, kSnapshotVersion);
+    appendBinary(data, store.generation);
+    appendBinary(data, store.journalBytes);
+    appendBinary(data, (uint32_t)table.typeNames.size());
+    for (size_t i = 0; i < table.typeNames.size(); ++i) {
+        appendBinaryString(data, table.typeNames[i]);
+    }
+    appendBinary(data, (uint32_t)table.amenityNames.size());
+    for (size_t i = 0; i < table.amenityNames.size(); ++i) {
+        appendBinaryString(data, table.amenityNames[i]);
+    }
+    appendBinary(data, (uint32_t)table.roomNumber.size());
+    appendColumn(data, table.roomNumber);
+    appendColumn(data, table.isBooked);
+    appendColumn(data, table.typeId);
+    appendColumn(data, table.pricePerDay);
+    appendColumn(data, table.amenities);
+    appendColumn(data, table.guest);
+    appendBinaryString(data, table.arena);
+    vector<long long> revenueByType = store.totals.revenueByType;
+    revenueByType.resize(table.typeNames.size(), 0); // One entry per room type
+    appendBinary(data, store.totals.stays);
+    appendBinary(data, store.totals.nights);
+    appendBinary(data, (uint32_t)revenueByType.size());
+    appendColumn(data, revenueByType);
+    appendBinary(data, fnv1a(data.data(), data.size()));
+    return replaceFileAtomically(store.snapshotPath, data);
+}
+
+// Function to restore the occupancy and guests of the rooms from the snapshot; returns false if
+// it is missing or damaged, or was saved for other rooms than those of the table
+bool loadRoomSnapshot(const string& path, RoomTable& table, ReportTotals& totals, long long& generation,
+                      long long& journalOffset) {
+    ifstream file(path, ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    uint32_t checksum;
+    if (data.size() < sizeof(checksum)) {
+        return false;
+    }
+    memcpy(&checksum, data.data() + data.size() - sizeof(checksum), sizeof(checksum));
+    if (checksum != fnv1a(data.data(), data.size() - sizeof(checksum))) {
+        return false;
+    }
+
+    SnapshotReader reader = { data.data(), data.size() - sizeof(checksum), 0 };
+    uint32_t magic, version, typeCount, amenityCount, roomCount;
+    if (!reader.read(magic) || magic != kSnapshotMagic || !reader.read(version) || version != kSnapshotVersion ||
+        !reader.read(generation) || !reader.read(journalOffset) || !reader.read(typeCount)) {
+        return false;
+    }
+
+    RoomTable loaded;
+    loaded.typeNames.resize(typeCount);
+    for (uint32_t i = 0; i < typeCount; ++i) {
+        if (!reader.readString(loaded.typeNames[i])) return false;
+    }
+    if (!reader.read(amenityCount) || amenityCount > 32) {
+        return false;
+    }
+    loaded.amenityNames.resize(amenityCount);
+    for (uint32_t i = 0; i < amenityCount; ++i) {
+        if (!reader.readString(loaded.amenityNames[i])) return false;
+    }
+    if (!reader.read(roomCount) || !reader.readColumn(loaded.roomNumber, roomCount) ||
+        !reader.readColumn(loaded.isBooked, roomCount) || !reader.readColumn(loaded.typeId, roomCount) ||
+        !reader.readColumn(loaded.pricePerDay, roomCount) || !reader.readColumn(loaded.amenities, roomCount) ||
+        !reader.readColumn(loaded.guest, roomCount) || !reader.readString(loaded.arena)) {
+        return false;
+    }
+    ReportTotals loadedTotals;
+    uint32_t revenueCount;
+    if (!reader.read(loadedTotals.stays) || !reader.read(loadedTotals.nights) || !reader.read(revenueCount) ||
+        revenueCount != typeCount || !reader.readColumn(loadedTotals.revenueByType, revenueCount)) {
+        return false;
+    }
+
+    // Every reference has to point inside the data that was loaded
+    for (uint32_t i = 0; i < roomCount; ++i) {
+        const RoomGuest& guest = loaded.guest[i];
+        const StringRef fields[] = { guest.customerName, guest.contactNumber, guest.emailAddress,
+                                     guest.numberOfDays, guest.checkInTime, guest.checkOutTime };
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f) {
+            if (fields[f].offset > loaded.arena.size() || loaded.arena.size() - fields[f].offset < fields[f].length) return false;
+            loaded.arenaLiveBytes += fields[f].length;
+        }
+        if (loaded.typeId[i] >= typeCount || guest.paymentMethod >= sizeof(kPaymentMethods) / sizeof(kPaymentMethods[0])) {
+            return false;
+        }
+    }
+    // The layout comes from createRooms(); the snapshot only caches the state of those rooms
+    if (loaded.roomNumber != table.roomNumber || loaded.typeId != table.typeId || loaded.typeNames != table.typeNames) {
+        return false;
+    }
+    table.isBooked.swap(loaded.isBooked);
+    table.guest.swap(loaded.guest);
+    table.arena.swap(loaded.arena);
+    table.arenaLiveBytes = loaded.arenaLiveBytes;
+    swap(totals, loadedTotals);
+    return true;
+}
+
+// Function to write journal lines and make them durable with fsync
+bool syncJournal(CustomerStore& store, const string& lines) {
+    OperationTimer timer(store.timings[kOpJournalSync]);
+    return writeFully(store.journalFd, lines) && fsync(store.journalFd) == 0;
+}
+
+// Function to append one record to the journal and make it durable.
+// In batch mode the record is only queued; commitJournalBatch writes it.
+long long appendJournalRecord(CustomerStore& store, const string& payload) {
+    string line = journalLine(payload);
+    long long offset = store.journalBytes;
+    if (store.batching) {
+        store.pendingJournal += line;
+    } else if (!syncJournal(store, line)) {
+        // Never leave a half-written record in front of the next one
+        if (ftruncate(store.journalFd, offset) != 0) {
+            cout << "\033[31mError: Could not repair the customer journal.\033[0m" << endl;
+        }
+        cout << "\033[31mError: Could not write to the customer journal.\033[0m" << endl;
+        return -1;
+    }
+    store.journalBytes += line.size();
+    store.recordsSinceCompaction++;
+    applyJournalRecord(store, payload, offset, line.size());
+    return offset;
+}
+
+// Function to write the queued batch records with a single write and fsync.
+// On failure the journal is cut back to its last durable size and the batch is dropped.
+bool flushJournalBatch(CustomerStore& store) {
+    if (store.pendingJournal.empty()) {
+        return true;
+    }
+    long long durableBytes = store.journalBytes - store.pendingJournal.size();
+    if (!syncJournal(store, store.pendingJournal)) {
+        if (ftruncate(store.journalFd, durableBytes) != 0) {
+            cout << "\033[31mError: Could not repair the customer journal.\033[0m" << endl;
+        }
+        store.journalBytes = durableBytes;
+        store.pendingJournal.clear();
+        return false;
+    }
+    store.pendingJournal.clear();
+    return true;
+}
+
+// Function to open (or re-open) the journal for appending
+bool openJournalForAppend(CustomerStore& store) {
+    if (store.journalFd >= 0) {
+        close(store.journalFd);
+    }
+    store.journalFd = open(store.journalPath.c_str(), O_RDWR | O_APPEND);
+    return store.journalFd >= 0;
+}
+
+// Function to move finished stays into the ledger and start a new journal with the open bookings
+bool compactCustomerStore(CustomerStore& store) {
+    OperationTimer timer(store.timings[kOpCompaction]);
+    if (!flushJournalBatch(store)) {
+        cout << "\033[31mError: Could not write to the customer journal.\033[0m" << endl;
+        return false;
+    }
+    string ledgerRows;
+    string carried;
+    map<long long, JournalBooking> kept;
+    int today = currentDay();
+
+    // The new header carries the totals of the stays in the ledger, so they survive a lost
+    // snapshot. Check-ins carried into the new journal are left out; replaying it counts them.
+    ReportTotals ledgerTotals = store.totals;
+    unordered_map<int, size_t> roomSlots;
+    if (store.rooms != NULL) {
+        for (size_t i = 0; i < store.rooms->roomNumber.size(); ++i) {
+            roomSlots[store.rooms->roomNumber[i]] = i;
+        }
+    }
+
+    for (map<long long, JournalBooking>::const_iterator it = store.bookings.begin(); it != store.bookings.end(); ++it) {
+        const JournalBooking& booking = it->second;
+        string payload;
+        if (!readBookingRecord(store, booking, payload)) {
+            cout << "\033[31mError: Customer journal is damaged, compaction skipped.\033[0m" << endl;
+            return false;
+        }
+        // B/R,id,room,name,contact,email,days,payment,arrivalDay
+        string_view fields[kMaxFields];
+        size_t fieldCount = tokenizeFields(payload, fields, kMaxFields);
+        if (fieldCount < 8) {
+            cout << "\033[31mError: Customer journal is damaged, compaction skipped.\033[0m" << endl;
+            return false;
+        }
+        if (booking.checkedOut || (!booking.active && booking.arrivalDay + booking.nights <= today)) {
+            // A finished stay, or a reservation whose nights have all passed without the guest arriving
+            ledgerRows.append(fields[3]).append(",").append(fields[2]).append(",");
+            if (booking.checkedOut) {
+                ledgerRows.append(booking.checkInTime).append(",").append(booking.checkOutTime);
+            } else {
+                ledgerRows.append(",No Show");
+            }
+            ledgerRows.append(",").append(fields[4]).append(",").append(fields[5]).append(",").append(fields[6]).append("\n");
+        } else {
+            // An older B record gets the arrival day it was loaded with, so it stays fixed from now on
+            string line = journalLine((fieldCount == 8) ? payload + "," + to_string(booking.arrivalDay) : payload);
+            JournalBooking moved = booking;
+            moved.offset = carried.size(); // Made absolute once the header size is known
+            moved.length = line.size();
+            carried += line;
+            string room(fields[2]);
+            if (booking.active && fields[0] == "R") {
+                carried += journalLine("A," + to_string(it->first) + "," + room);
+            }
+            if (!booking.checkInTime.empty()) {
+                carried += journalLine("I," + to_string(it->first) + "," + room + "," + booking.checkInTime);
+                unordered_map<int, size_t>::const_iterator slot = roomSlots.find(booking.roomNumber);
+                if (slot != roomSlots.end()) {
+                    countCheckIn(ledgerTotals, *store.rooms, slot->second, booking.nights, -1);
+                }
+            }
+            kept[it->first] = moved;
+        }
+    }
+
+    // The ledger is appended first. Until the new journal is in place, the old journal's
+    // header still holds the old ledger size, so recovery drops these rows again.
+    if (!ledgerRows.empty()) {
+        int ledgerFd = open(store.ledgerPath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        bool written = ledgerFd >= 0 && writeFully(ledgerFd, ledgerRows) && fsync(ledgerFd) == 0;
+        if (ledgerFd >= 0) close(ledgerFd);
+        if (!written) {
+            cout << "\033[31mError: Could not write to " << store.ledgerPath << ".\033[0m" << endl;
+            return false;
+        }
+        appendLedgerIndex(store, ledgerRows, store.ledgerBytes);
+    }
+
+    long long newLedgerBytes = store.ledgerBytes + ledgerRows.size();
+    string header = journalLine("H," + to_string(store.generation + 1) + "," + to_string(newLedgerBytes) + "," +
+                                to_string(store.nextBookingId) + "," + formatReportTotals(ledgerTotals) + "," +
+                                to_string(store.uncountedLedgerBytes));
+    if (!replaceFileAtomically(store.journalPath, header + carried) || !openJournalForAppend(store)) {
+        cout << "\033[31mError: Could not rewrite the customer journal.\033[0m" << endl;
+        return false;
+    }
+
+    for (map<long long, JournalBooking>::iterator it = kept.begin(); it != kept.end(); ++it) {
+        it->second.offset += header.size();
+    }
+    store.bookings.swap(kept);
+    store.generation++;
+    store.ledgerBytes = newLedgerBytes;
+    store.journalBytes = header.size() + carried.size();
+    store.recordsSinceCompaction = 0;
+
+    // A failed snapshot only makes the next startup replay the whole (short) journal
+    if (store.rooms != NULL && !saveRoomSnapshot(store)) {
+        cout << "\033[31mError: Could not save " << store.snapshotPath << ".\033[0m" << endl;
+    }
+    return true;
+}
+
+// Function to check whether enough records have piled up to compact the journal. Compaction
+// rewrites every booking the journal holds, so it waits for at least that many records, which
+// keeps its cost per record constant however many bookings are open.
+bool compactionDue(const CustomerStore& store) {
+    return (size_t)store.recordsSinceCompaction >= max(kCompactionThreshold, store.bookings.size());
+}
+
+// Function to compact the journal once enough records have piled up
+void maybeCompactCustomerStore(CustomerStore& store) {
+    if (!store.batching && compactionDue(store)) {
+        compactCustomerStore(store);
+    }
+}
+
+// Function to start collecting journal records instead of writing each one
+void beginJournalBatch(CustomerStore& store) {
+    store.batching = true;
+}
+
+// Function to make the records of the current batch durable, compacting afterwards if due
+bool commitJournalBatch(CustomerStore& store) {
+    bool written = flushJournalBatch(store);
+    store.batching = false;
+    if (written) {
+        maybeCompactCustomerStore(store);
+    }
+    return written;
+}
+
+// Function to open the customer store and restore the rooms, recovering from an interrupted run if needed
+bool openCustomerStore(CustomerStore& store, const string& ledgerPath, RoomTable& rooms) {
+    OperationTimer timer(store.timings[kOpOpenStore]);
+    store.ledgerPath = ledgerPath;
+    store.journalPath = siblingPath(ledgerPath, ".journal");
+    store.snapshotPath = siblingPath(ledgerPath, ".snapshot");
+    store.indexPath = siblingPath(ledgerPath, ".idx");
+    store.keyPath = siblingPath(ledgerPath, ".keys");
+    store.rooms = &rooms;
+
+    long long ledgerSize = max(fileSize(ledgerPath), 0LL);
+    if (fileSize(store.journalPath) < 0) {
+        // First start: any existing ledger is kept as history
+        if (!replaceFileAtomically(store.journalPath, journalLine("H,1," + to_string(ledgerSize) + ",1"))) {
+            cout << "\033[31mError: Could not create " << store.journalPath << ".\033[0m" << endl;
+            return false;
+        }
+    }
+
+    // Map the journal instead of copying it into memory
+    int fd = open(store.journalPath.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        cout << "\033[31mError: Could not open " << store.journalPath << ".\033[0m" << endl;
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    size_t size = info.st_size;
+    void* mapping = (size > 0) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        cout << "\033[31mError: " << store.journalPath << " has no valid header.\033[0m" << endl;
+        return false;
+    }
+    const char* data = static_cast<const char*>(mapping);
+
+    const char* newline = static_cast<const char*>(memchr(data, '\n', size));
+    string_view payload;
+    // H,generation,ledgerBytes,nextBookingId[,stays,nights,revenue;revenue;...,uncountedLedgerBytes]
+    // (the totals are missing from journals that were never compacted; then the whole ledger is uncounted)
+    string_view header[kMaxFields];
+    size_t headerFields = 0;
+    if (newline != NULL && verifyJournalLine(string_view(data, newline - data), payload)) {
+        headerFields = tokenizeFields(payload, header, kMaxFields);
+    }
+    if ((headerFields != 4 && headerFields != 8) || header[0] != "H") {
+        cout << "\033[31mError: " << store.journalPath << " has no valid header.\033[0m" << endl;
+        munmap(mapping, size);
+        return false;
+    }
+    store.generation = fieldNumber(header[1]);
+    store.ledgerBytes = fieldNumber(header[2]);
+    store.nextBookingId = fieldNumber(header[3]);
+    store.uncountedLedgerBytes = (headerFields == 8) ? fieldNumber(header[7]) : store.ledgerBytes;
+    store.bookings.clear();
+    store.openBookingByRoom.clear();
+
+    // The snapshot covers the journal up to its recorded offset. If it belongs to another
+    // generation (a crash between compaction and snapshot), the occupancy is cleared and
+    // the whole journal is replayed, which works because the journal carries every open booking.
+    size_t headerEnd = newline - data + 1;
+    long long snapshotGeneration = 0, snapshotOffset = 0;
+    size_t replayFrom = headerEnd;
+    bool snapshotValid = loadRoomSnapshot(store.snapshotPath, rooms, store.totals, snapshotGeneration, snapshotOffset) &&
+                         snapshotGeneration == store.generation && snapshotOffset >= (long long)headerEnd &&
+                         snapshotOffset <= (long long)size;
+    if (snapshotValid) {
+        replayFrom = snapshotOffset;
+    } else {
+        // The totals start from those of the ledger; replaying the journal adds its check-ins
+        if (headerFields == 8) {
+            parseReportTotals(header[4], header[5], header[6], store.totals);
+        } else {
+            store.totals = ReportTotals();
+        }
+        for (size_t i = 0; i < rooms.roomNumber.size(); ++i) {
+            rooms.isBooked[i] = 0;
+            clearRoomGuest(rooms, i);
+        }
+    }
+    unordered_map<int, size_t> roomIndex;
+    for (size_t i = 0; i < rooms.roomNumber.size(); ++i) {
+        roomIndex[rooms.roomNumber[i]] = i;
+    }
+
+    // Replay the records; stop at the first torn or corrupt one. The index needs the whole
+    // journal (it is bounded by compaction); the rooms only need what the snapshot lacks.
+    size_t offset = headerEnd;
+    while (offset < size) {
+        newline = static_cast<const char*>(memchr(data + offset, '\n', size - offset));
+        if (newline == NULL) {
+            break;
+        }
+        size_t length = newline - (data + offset) + 1;
+        if (!verifyJournalLine(string_view(data + offset, length - 1), payload) ||
+            !applyJournalRecord(store, payload, offset, length)) {
+            break;
+        }
+        if (offset >= replayFrom) {
+            applyRoomRecord(rooms, roomIndex, store, data, payload);
+        }
+        offset += length;
+    }
+    munmap(mapping, size);
+    store.journalBytes = offset;
+    store.recordsSinceCompaction = 0;
+
+    if (offset < size) {
+        cout << "\033[33mRecovered customer journal: dropped " << size - offset
+             << " bytes of an incomplete record.\033[0m" << endl;
+        if (truncate(store.journalPath.c_str(), offset) != 0) {
+            cout << "\033[31mError: Could not truncate " << store.journalPath << ".\033[0m" << endl;
+            return false;
+        }
+    }
+
+    // Rows beyond the recorded size come from a compaction that did not finish;
+    // the journal still holds those stays, so they are dropped from the ledger.
+    if (ledgerSize > store.ledgerBytes) {
+        if (truncate(ledgerPath.c_str(), store.ledgerBytes) != 0) {
+            cout << "\033[31mError: Could not truncate " << ledgerPath << ".\033[0m" << endl;
+            return false;
+        }
+    } else if (ledgerSize < store.ledgerBytes) {
+        cout << "\033[33mWarning: " << ledgerPath << " is shorter than expected.\033[0m" << endl;
+        store.ledgerBytes = ledgerSize;
+    }
+    trimLedgerIndex(store);
+
+    if (!openJournalForAppend(store)) {
+        cout << "\033[31mError: Could not open " << store.journalPath << " for writing.\033[0m" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to compact and close the customer store on exit
+void closeCustomerStore(CustomerStore& store) {
+    if (store.journalFd < 0) {
+        return;
+    }
+    compactCustomerStore(store);
+    close(store.journalFd);
+    store.journalFd = -1;
+}
+
+// Function to record a new booking (starting today) or reservation (starting later) in the journal.
+// Returns the booking id, or -1 if the journal could not be written.
+long long recordBooking(CustomerStore& store, const BookingRequest& request, bool startsToday) {
+    long long bookingId = store.nextBookingId;
+    string payload = string(startsToday ? "B," : "R,") + to_string(bookingId) + "," + to_string(request.roomNumber) + "," +
+                     request.customerName + "," + request.contactNumber + "," + request.emailAddress + "," +
+                     request.numberOfDays + "," + request.paymentMethod + "," + to_string(request.arrivalDay);
+    if (appendJournalRecord(store, payload) < 0) {
+        return -1;
+    }
+    maybeCompactCustomerStore(store);
+    return bookingId;
+}
+
+// Function to record that the guest of a reservation has arrived and now occupies the room
+bool recordArrival(CustomerStore& store, int roomNumber, long long bookingId) {
+    if (appendJournalRecord(store, "A," + to_string(bookingId) + "," + to_string(roomNumber)) < 0) {
+        return false;
+    }
+    maybeCompactCustomerStore(store);
+    return true;
+}
+
+// Function to record the check-in time of a room's open booking
+bool updateCheckInTime(CustomerStore& store, int roomNumber, const string& checkInTime) {
+    OperationTimer timer(store.timings[kOpUpdateCheckInTime]);
+    unordered_map<int, long long>::const_iterator open = store.openBookingByRoom.find(roomNumber);
+    if (open == store.openBookingByRoom.end()) {
+        cout << "\033[31mError: Room number not found in the file.\033[0m" << endl;
+        return false;
+    }
+    if (appendJournalRecord(store, "I," + to_string(open->second) + "," + to_string(roomNumber) + "," + checkInTime) < 0) {
+        return false;
+    }
+    maybeCompactCustomerStore(store);
+    return true;
+}
+
+// Function to record the check-out time of a room's open booking.
+// The caller compacts (maybeCompactCustomerStore) once the room is reset.
+bool updateCheckOutTime(CustomerStore& store, int roomNumber, const string& checkoutTime) {
+    OperationTimer timer(store.timings[kOpUpdateCheckOutTime]);
+    unordered_map<int, long long>::const_iterator open = store.openBookingByRoom.find(roomNumber);
+    if (open == store.openBookingByRoom.end()) {
+        cout << "\033[31mError: Room number not found in the file.\033[0m" << endl;
+        return false;
+    }
+    return appendJournalRecord(store, "O," + to_string(open->second) + "," + to_string(roomNumber) + "," + checkoutTime) >= 0;
+}
+
+// ---------------------------------------------------------------------------
+// Reservation calendar
+//
+// Each room keeps its reservations in a map ordered by arrival day, so checking a
+// new date range against them is a single O(log n) lookup. On top of that the
+// calendar keeps one bitset per night for the next two years (bit i set = the room
+// at position i is taken that night). Finding the free rooms of a type over a
+// range ORs the nights together 64 rooms per word. Dates are day numbers.
+// ---------------------------------------------------------------------------
+
+const int kCalendarDays = 732; // Nights covered by the occupancy bitsets, starting today
+
+struct Reservation {
+    int endDay;          // Day after the last night
+    long long bookingId;
+};
+
+struct ReservationCalendar {
+    int firstDay;                            // Night of the first occupancy bitset
+    size_t words;                            // 64-bit words per bitset
+    vector<map<int, Reservation> > byRoom;   // Room position -> arrival day -> reservation
+    vector<vector<uint64_t> > roomsOfType;   // Room type id -> bitset of room positions
+    vector<vector<uint64_t> > occupied;      // Night - firstDay -> bitset of taken rooms
+};
+
+// Function to set up an empty calendar for the rooms, starting at the given night
+void buildReservationCalendar(ReservationCalendar& calendar, const RoomTable& table, int firstDay) {
+    size_t count = table.roomNumber.size();
+    calendar.firstDay = firstDay;
+    calendar.words = (count + 63) / 64;
+    calendar.byRoom.assign(count, map<int, Reservation>());
+    calendar.roomsOfType.assign(table.typeNames.size(), vector<uint64_t>(calendar.words, 0));
+    calendar.occupied.assign(kCalendarDays, vector<uint64_t>(calendar.words, 0));
+    for (size_t i = 0; i < count; ++i) {
+        calendar.roomsOfType[table.typeId[i]][i / 64] |= 1ULL << (i % 64);
+    }
+}
+
+// Function to mark the nights [from, to) of a room as taken or free in the bitsets
+void markNights(ReservationCalendar& calendar, size_t slot, int from, int to, bool taken) {
+    int start = max(from, calendar.firstDay);
+    int end = min(to, calendar.firstDay + kCalendarDays);
+    uint64_t mask = 1ULL << (slot % 64);
+    for (int day = start; day < end; ++day) {
+        uint64_t& word = calendar.occupied[day - calendar.firstDay][slot / 64];
+        word = taken ? (word | mask) : (word & ~mask);
+    }
+}
+
+// Function to check whether any of the nights [from, to) of a room is already reserved
+bool hasReservationConflict(const ReservationCalendar& calendar, size_t slot, int from, int to) {
+    const map<int, Reservation>& reservations = calendar.byRoom[slot];
+    map<int, Reservation>::const_iterator next = reservations.lower_bound(from);
+    if (next != reservations.end() && next->first < to) {
+        return true; // A reservation arrives during the stay
+    }
+    if (next != reservations.begin()) {
+        --next;
+        if (next->second.endDay > from) {
+            return true; // The previous reservation is still there when the stay starts
+        }
+    }
+    return false;
+}
+
+// Function to reserve the nights [from, to) of a room; returns false if they overlap another reservation
+bool addReservation(ReservationCalendar& calendar, size_t slot, int from, int to, long long bookingId) {
+    if (from >= to || hasReservationConflict(calendar, slot, from, to)) {
+        return false;
+    }
+    Reservation reservation = { to, bookingId };
+    calendar.byRoom[slot][from] = reservation;
+    markNights(calendar, slot, from, to, true);
+    return true;
+}
+
+// Function to remove the reservation of a room that starts on the given night
+void removeReservation(ReservationCalendar& calendar, size_t slot, int from) {
+    map<int, Reservation>::iterator found = calendar.byRoom[slot].find(from);
+    if (found != calendar.byRoom[slot].end()) {
+        markNights(calendar, slot, from, found->second.endDay, false);
+        calendar.byRoom[slot].erase(found);
+    }
+}
+
+// Function to find the booking that holds a room on a given night (-1 if none)
+long long reservationOn(const ReservationCalendar& calendar, size_t slot, int day) {
+    const map<int, Reservation>& reservations = calendar.byRoom[slot];
+    map<int, Reservation>::const_iterator found = reservations.upper_bound(day);
+    if (found == reservations.begin()) {
+        return -1;
+    }
+    --found;
+    return (found->second.endDay > day) ? found->second.bookingId : -1;
+}
+
+// Function to list the rooms of a type that are free on every night in [from, to)
+vector<size_t> findFreeRooms(const ReservationCalendar& calendar, int type, int from, int to) {
+    vector<size_t> freeRooms;
+    if (type < 0 || from >= to) {
+        return freeRooms;
+    }
+    if (from < calendar.firstDay || to > calendar.firstDay + kCalendarDays) {
+        // Outside the bitsets: ask each room of the type
+        for (size_t slot = 0; slot < calendar.byRoom.size(); ++slot) {
+            if ((calendar.roomsOfType[type][slot / 64] >> (slot % 64) & 1) && !hasReservationConflict(calendar, slot, from, to)) {
+                freeRooms.push_back(slot);
+            }
+        }
+        return freeRooms;
+    }
+
+    vector<uint64_t> taken(calendar.words, 0);
+    for (int day = from; day < to; ++day) {
+        const vector<uint64_t>& night = calendar.occupied[day - calendar.firstDay];
+        for (size_t w = 0; w < calendar.words; ++w) {
+            taken[w] |= night[w];
+        }
+    }
+    for (size_t w = 0; w < calendar.words; ++w) {
+        uint64_t candidates = calendar.roomsOfType[type][w] & ~taken[w];
+        while (candidates != 0) {
+            freeRooms.push_back(w * 64 + __builtin_ctzll(candidates));
+            candidates &= candidates - 1;
+        }
+    }
+    return freeRooms;
+}
+
+// Function to enter every open booking and reservation of the store into the calendar
+void loadReservations(ReservationCalendar& calendar, const RoomInventory& inventory, const CustomerStore& store) {
+    for (map<long long, JournalBooking>::const_iterator it = store.bookings.begin(); it != store.bookings.end(); ++it) {
+        const JournalBooking& booking = it->second;
+        size_t slot = findRoomSlot(inventory, booking.roomNumber);
+        if (!booking.checkedOut && slot != kNoRoom) {
+            addReservation(calendar, slot, booking.arrivalDay, booking.arrivalDay + booking.nights, it->first);
+        }
+    }
+}
+
+// Function to let the guest of a reservation that covers today into the room.
+// Returns true if the room is now occupied by that guest.
+bool activateReservation(RoomTable& rooms, RoomInventory& inventory, const ReservationCalendar& calendar,
+                         CustomerStore& store, size_t slot) {
+    long long bookingId = reservationOn(calendar, slot, currentDay());
+    map<long long, JournalBooking>::const_iterator found = store.bookings.find(bookingId);
+    if (bookingId < 0 || found == store.bookings.end() || found->second.active) {
+        return false;
+    }
+    string payload;
+    if (!readBookingRecord(store, found->second, payload)) {
+        return false;
+    }
+    string_view fields[kMaxFields];
+    if (tokenizeFields(payload, fields, kMaxFields) != 9) {
+        return false;
+    }
+    BookingRequest request = bookingFromRecord(fields, found->second);
+    // The room is taken before the journal, so a snapshot taken by the write includes the guest
+    occupyRoom(rooms, slot, request);
+    setRoomFree(inventory, rooms, slot, false);
+    if (!recordArrival(store, request.roomNumber, bookingId)) {
+        rooms.isBooked[slot] = 0;
+        clearRoomGuest(rooms, slot);
+        setRoomFree(inventory, rooms, slot, true);
+        return false;
+    }
+    return true;
+}
+
+// Function to free the remaining nights of a booking when the guest leaves
+void releaseReservation(ReservationCalendar& calendar, const CustomerStore& store, size_t slot, long long bookingId) {
+    map<long long, JournalBooking>::const_iterator booking = store.bookings.find(bookingId);
+    if (booking != store.bookings.end()) {
+        removeReservation(calendar, slot, booking->second.arrivalDay);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Hotel operations
+//
+// The checks and state changes behind booking, check-in and check-out, without
+// prompts or console output. The menu and the batch mode both go through these.
+// Each returns an empty string on success, or the reason it was refused.
+// ---------------------------------------------------------------------------
+
+// Function to check every field of a booking request
+string bookingRequestError(const BookingRequest& request) {
+    if (!isValidCustomerName(request.customerName)) {
+        return "Invalid customer name! Use letters, spaces, or hyphens only.";
+    }
+    if (!isValidContactNumber(request.contactNumber)) {
+        return "Invalid contact number! Enter digits only (7-15 characters).";
+    }
+    if (!isValidGuestEmail(request.emailAddress)) {
+        return "Invalid email address.";
+    }
+    if (!isValidStayLength(request.numberOfDays)) {
+        return "Invalid number of days! Enter a valid positive integer.";
+    }
+    if (!isValidPaymentMethod(request.paymentMethod)) {
+        return "Invalid payment method. Use 'Cash' or 'Credit'.";
+    }
+    if (request.arrivalDay < currentDay()) {
+        return "Invalid date! Enter a date from today onwards.";
+    }
+    return "";
+}
+
+// Function to book a room for the nights of a (valid) request. A stay starting
+// today takes the room at once; a later one is kept as a reservation.
+string placeBooking(RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar, CustomerStore& store,
+                    const BookingRequest& request) {
+    OperationTimer timer(store.timings[kOpBookRoom]);
+    size_t slot = findRoomSlot(inventory, request.roomNumber);
+    if (slot == kNoRoom) {
+        return "Room " + to_string(request.roomNumber) + " does not exist!";
+    }
+    int endDay = request.arrivalDay + stoi(request.numberOfDays);
+    bool startsToday = request.arrivalDay == currentDay();
+    if ((startsToday && rooms.isBooked[slot]) || hasReservationConflict(calendar, slot, request.arrivalDay, endDay)) {
+        return "Room " + to_string(request.roomNumber) + " is already booked for those dates!";
+    }
+
+    // The room is taken before the journal, so a snapshot taken by the write includes the guest;
+    // it is given back if the booking could not be saved
+    if (startsToday) {
+        occupyRoom(rooms, slot, request);
+        setRoomFree(inventory, rooms, slot, false);
+    }
+    long long bookingId = recordBooking(store, request, startsToday);
+    if (bookingId < 0) {
+        if (startsToday) {
+            rooms.isBooked[slot] = 0;
+            clearRoomGuest(rooms, slot);
+            setRoomFree(inventory, rooms, slot, true);
+        }
+        return "Could not write to the customer journal.";
+    }
+    addReservation(calendar, slot, request.arrivalDay, endDay, bookingId);
+    return "";
+}
+
+// Function to record the check-in of a booked room that is not checked in yet
+string completeCheckIn(RoomTable& rooms, CustomerStore& store, size_t slot, const string& checkInTime) {
+    OperationTimer timer(store.timings[kOpCheckInRoom]);
+    int roomNumber = rooms.roomNumber[slot];
+    RoomGuest& guest = rooms.guest[slot];
+    if (!rooms.isBooked[slot]) {
+        return "Room " + to_string(roomNumber) + " is not booked yet!";
+    }
+    if (guest.checkInTime.length != 0) {
+        return "Room " + to_string(roomNumber) + " is already checked-in.";
+    }
+    // The room and the totals are updated before the journal, so a snapshot taken by the write includes them
+    unordered_map<int, long long>::const_iterator open = store.openBookingByRoom.find(roomNumber);
+    int nights = (open == store.openBookingByRoom.end()) ? 0 : store.bookings[open->second].nights;
+    setRoomText(rooms, guest.checkInTime, checkInTime);
+    countCheckIn(store.totals, rooms, slot, nights);
+    if (!updateCheckInTime(store, roomNumber, checkInTime)) {
+        setRoomText(rooms, guest.checkInTime, "");
+        countCheckIn(store.totals, rooms, slot, nights, -1);
+        return "Could not write to the customer journal.";
+    }
+    return "";
+}
+
+// Function to check out a booked room, freeing it and any nights left of its booking
+string completeCheckOut(RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar, CustomerStore& store,
+                        size_t slot) {
+    OperationTimer timer(store.timings[kOpCheckOutRoom]);
+    int roomNumber = rooms.roomNumber[slot];
+    if (!rooms.isBooked[slot]) {
+        return "Room " + to_string(roomNumber) + " is already free!";
+    }
+    unordered_map<int, long long>::const_iterator open = store.openBookingByRoom.find(roomNumber);
+    long long bookingId = (open == store.openBookingByRoom.end()) ? -1 : open->second;
+
+    // Journal the check-out first, so a failed write leaves the stay as it was
+    if (!updateCheckOutTime(store, roomNumber, getCurrentTime())) {
+        return "Could not write to the customer journal.";
+    }
+    rooms.isBooked[slot] = 0;
+    setRoomFree(inventory, rooms, slot, true);
+    releaseReservation(calendar, store, slot, bookingId); // Any nights left become free again
+
+    // Reset room details
+    clearRoomGuest(rooms, slot);
+
+    // Compact only once the room is reset, so a snapshot taken now is consistent
+    maybeCompactCustomerStore(store);
+    return "";
+}
+
+// Function to book a room, from today or as a reservation for later dates
+void bookRoom(RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar, CustomerStore& store) {
+    BookingRequest request;
+    string arrivalDate;
+
+    cout << "\033[34mEnter Room Number to Book: ";
+
+    try {
+        // Error handling for non-integer input
+        if (!(cin >> request.roomNumber)) {
+            throw invalid_argument("\033[31mInvalid input! Please enter a valid room number (integer).\033[0m");
+        }
+        int roomNumber = request.roomNumber;
+        size_t slot = findRoomSlot(inventory, roomNumber);
+        if (slot == kNoRoom) {
+            cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
+            return;
+        }
+
+        cout << "\033[38;5;141mEnter Customer Name: ";
+        cin.ignore(); // Clear input buffer before taking string input
+        while (true) {
+            try {
+                getline(cin, request.customerName);
+
+                // Validate customer name: must not be empty and must only contain valid characters
+                if (request.customerName.empty()) {
+                    throw invalid_argument("\033[31mCustomer name cannot be empty! Please enter a valid name.\033[0m");
+                }
+                if (!isValidCustomerName(request.customerName)) {
+                    throw invalid_argument("\033[31mInvalid characters in name! Use letters, spaces, or hyphens only.\033[0m");
+                }
+                break; // Exit loop if valid
+            } catch (const invalid_argument& e) {
+                cout << e.what() << endl;
+                cout << "Please re-enter Customer Name: ";
+            }
+        }
+
+        while (true) {
+            cout << "\033[33mEnter Contact Number: ";
+            try {
+                getline(cin, request.contactNumber);
+
+                // Validate contact number (digits only, length between 7 and 15)
+                if (!isValidContactNumber(request.contactNumber)) {
+                    throw invalid_argument("\033[31mInvalid contact number! Enter digits only (7-15 characters).\033[0m");
+                }
+                break; // Exit loop if valid
+            } catch (const invalid_argument& e) {
+                cout << e.what() << endl;
+            }
+        }
+
+        // Enter email with validation
+        while (true) {
+            cout << "\033[38;5;111mEnter Email Address: ";
+            getline(cin, request.emailAddress);
+
+            // Check if email contains '@' and '.' in valid positions
+            if (isValidGuestEmail(request.emailAddress)) {
+                break; // Valid email, exit the loop
+            } else {
+                cout << "\033[31mInvalid email address. Please enter a valid email.\033[0m" << endl;
+            }
+        }
+
+        // Arrival date: today, or a later day for an advance reservation
+        int today = currentDay();
+        while (true) {
+            cout << "\033[38;5;45mEnter Arrival Date (YYYY-MM-DD, leave empty for today): ";
+            getline(cin, arrivalDate);
+            if (arrivalDate.empty()) {
+                request.arrivalDay = today;
+                break;
+            }
+            if (parseDay(arrivalDate, request.arrivalDay) && request.arrivalDay >= today) {
+                break;
+            }
+            cout << "\033[31mInvalid date! Enter a date from today onwards as YYYY-MM-DD.\033[0m" << endl;
+        }
+
+        // Input validation for number of days (string input)
+        while (true) {
+            cout << "\033[38;5;45mEnter Number of Days for Stay: ";
+            getline(cin, request.numberOfDays); // Keep as string input
+
+            // Validate if numberOfDays contains only digits and is a positive integer
+            if (isValidStayLength(request.numberOfDays)) {
+                // Valid input, break out of the loop
+                break;
+            } else {
+                cout << "\033[31mInvalid input! Enter a valid positive integer.\033[0m" << endl;
+            }
+        }
+
+        // The nights must not overlap another booking of this room
+        int endDay = request.arrivalDay + stoi(request.numberOfDays);
+        bool startsToday = request.arrivalDay == today;
+        if ((startsToday && rooms.isBooked[slot]) || hasReservationConflict(calendar, slot, request.arrivalDay, endDay)) {
+            cout << "\033[34mRoom " << roomNumber << " is already booked for those dates!\033[0m" << endl;
+            vector<size_t> freeRooms = findFreeRooms(calendar, rooms.typeId[slot], request.arrivalDay, endDay);
+            for (size_t i = 0; i < freeRooms.size(); ++i) {
+                if (!(startsToday && rooms.isBooked[freeRooms[i]])) {
+                    cout << "\033[34mRoom " << rooms.roomNumber[freeRooms[i]] << " is the first free "
+                         << rooms.typeNames[rooms.typeId[slot]] << " room for those dates.\033[0m" << endl;
+                    break;
+                }
+            }
+            return;
+        }
+
+        // Inside the bookRoom function after gathering other details:
+        while (true) {
+            cout << "\033[38;5;141mEnter Payment Method (Cash/Credit): ";
+            getline(cin, request.paymentMethod);  // Read the payment method
+
+            // Validate payment method
+            if (isValidPaymentMethod(request.paymentMethod)) {
+                break;  // Valid input, exit the loop
+            } else {
+                cout << "\033[31mInvalid payment method. Please enter 'Cash' or 'Credit'.\033[0m" << endl;
+            }
+        }
+
+        string error = placeBooking(rooms, inventory, calendar, store, request);
+        if (!error.empty()) {
+            cout << "\033[31m" << error << "\033[0m" << endl;
+        } else if (startsToday) {
+            cout << "\033[32mRoom " << roomNumber << " has been booked successfully!\033[0m" << endl;
+        } else {
+            cout << "\033[32mRoom " << roomNumber << " has been reserved from " << formatDay(request.arrivalDay) << " for "
+                 << request.numberOfDays << " nights!\033[0m" << endl;
+        }
+    }
+    catch (const invalid_argument& e) {
+        cout << e.what() << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    catch (const runtime_error& e) {
+        cout << e.what() << endl;
+    }
+}
+
+// Function to list the free rooms of a type for a range of dates
+void searchFreeRooms(const RoomTable& rooms, const ReservationCalendar& calendar) {
+    string roomType;
+    string arrivalDate;
+    string nights;
+    int arrivalDay;
+
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "\033[34mEnter Room Type (Single/Double/Suite): \033[0m";
+    getline(cin, roomType);
+    int type = roomTypeId(rooms, roomType);
+    if (type < 0) {
+        cout << "\033[31mUnknown room type: " << roomType << "\033[0m" << endl;
+        return;
+    }
+    cout << "\033[34mEnter Arrival Date (YYYY-MM-DD): \033[0m";
+    getline(cin, arrivalDate);
+    if (!parseDay(arrivalDate, arrivalDay)) {
+        cout << "\033[31mInvalid date! Enter the date as YYYY-MM-DD.\033[0m" << endl;
+        return;
+    }
+    cout << "\033[34mEnter Number of Nights: \033[0m";
+    getline(cin, nights);
+    if (!isValidStayLength(nights)) {
+        cout << "\033[31mInvalid input! Enter a valid positive integer.\033[0m" << endl;
+        return;
+    }
+
+    vector<size_t> freeRooms = findFreeRooms(calendar, type, arrivalDay, arrivalDay + stoi(nights));
+    cout << "\n\033[38;5;223mFree " << roomType << " rooms from " << arrivalDate << " for " << nights << " nights ("
+         << freeRooms.size() << "):\033[0m" << endl;
+    for (size_t i = 0; i < freeRooms.size(); ++i) {
+        if (i % 10 == 0) cout << endl; // New row every 10 rooms
+        cout << "|Room" << setw(3) << rooms.roomNumber[freeRooms[i]] << "| ";
+    }
+    cout << endl;
+}
+
+
+
+/*void clearFileAndAddNewData(const std::string& filename)
+ {
+    // Open the file in write mode with truncation (this clears the file)
+    std::ofstream file(filename, std::ios::trunc);
+
+    if (file.is_open()) {
+        // Now the file is empty. You can start adding new data.
+       
+
+        // Close the file after adding new data
+        file.close();
+    } else {
+        std::cerr  << std::endl;
+    }
+ }
+ */
+
+
+// ---------------------------------------------------------------------------
+// Reports
+//
+// Report rows are collected in a ReportWriter and written to the screen in large
+// blocks instead of one flush per row. The customer report is shown a page at a
+// time and can be filtered by room, guest, dates or status; the filters are
+// checked against the ledger index first, so only matching rows are read from
+// CustomerData.txt.
+// ---------------------------------------------------------------------------
+
+const size_t kReportPageSize = 20;         // Customer rows per page
+const size_t kReportBufferBytes = 1 << 16; // Report output is written to the screen in blocks of this size
+
+// Collects report output until it is written to the screen
+struct ReportWriter {
+    ostream* out;  // The screen, or a benchmark's sink
+    string buffer;
+
+    ReportWriter() : out(&cout) {}
+};
+
+// Function to write the collected report output to the screen
+void flushReport(ReportWriter& writer) {
+    writer.out->write(writer.buffer.data(), writer.buffer.size());
+    writer.out->flush();
+    writer.buffer.clear();
+}
+
+// Function to add text to a report
+void writeText(ReportWriter& writer, string_view text) {
+    writer.buffer.append(text.data(), text.size());
+    if (writer.buffer.size() >= kReportBufferBytes) {
+        flushReport(writer);
+    }
+}
+
+// Function to write a field right-aligned in a column, the same as setw on the colored string
+void writeColumn(ReportWriter& writer, string_view text, int width, const char* color = "") {
+    size_t colorLength = strlen(color);
+    int used = text.size() + (colorLength != 0 ? colorLength + 4 : 0); // "\033[0m" is 4 characters
+    writer.buffer.append(max(width - used, 0), ' ');
+    writer.buffer.append(color, colorLength);
+    writeText(writer, text);
+    if (colorLength != 0) {
+        writeText(writer, "\033[0m");
+    }
+}
+
+// Function to write one customer row (name,roomNo,checkIn,checkOut,contact,email,days)
+void writeCustomerRow(ReportWriter& writer, const string_view* fields) {
+    writeColumn(writer, fields[0], 25, "\033[33m");
+    writeColumn(writer, fields[1], 15);
+    writeColumn(writer, fields[2], 25);
+    if (fields[3] == "-") {
+        writeColumn(writer, "\t\tNot Checked Out", 27, "\033[31m"); // Mark rooms not checked out
+    } else {
+        writeColumn(writer, fields[3], 27);
+    }
+    writeColumn(writer, fields[4], 31, "\033[32m");
+    writeColumn(writer, fields[5], 36, "\033[34m");
+    writeColumn(writer, fields[6], 27, "\033[35m");
+    writeText(writer, "\n");
+}
+
+// Function to split a ledger row into the seven customer columns
+void ledgerRowFields(string_view row, string_view* fields) {
+    size_t fieldCount = tokenizeFields(row, fields, 7);
+    if (fieldCount > 7) {
+        // The days column runs to the end of the line
+        fields[6] = row.substr(fields[6].data() - row.data());
+    }
+    for (size_t i = fieldCount; i < 7; ++i) {
+        fields[i] = string_view();
+    }
+}
+
+// Which customer rows a report shows
+struct ReportFilter {
+    int roomNumber;   // 0 for every room
+    string guestName; // Empty for every guest; compared without regard to letter case
+    int fromDay;      // Stays that overlap fromDay..toDay (both included)
+    int toDay;
+    string status;    // "Checked Out", "No Show", "Checked In", "Booked", "Reserved" or empty for all
+
+    ReportFilter() : roomNumber(0), fromDay(INT_MIN), toDay(INT_MAX) {}
+};
+
+// Where the next page of a customer report starts
+struct ReportCursor {
+    bool started;
+    int keyKind;             // Keys the ledger rows are looked up by, or -1 to go through the rows in order
+    size_t keyPosition;      // Next key of the lookup
+    size_t keyEnd;
+    size_t rowPosition;      // Next index entry to go through in order (those the keys do not cover, or all)
+    long long nextBookingId; // Next journal booking, once the ledger is done
+    bool finished;
+
+    ReportCursor()
+        : started(false), keyKind(-1), keyPosition(0), keyEnd(0), rowPosition(0), nextBookingId(0), finished(false) {}
+};
+
+// Function to compare two guest names without regard to letter case
+bool sameGuestName(string_view a, string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to check whether a stay from firstDay to lastDay overlaps the filter's dates
+// (-1 for a day that is not known; a stay with neither day never matches a date filter)
+bool stayInDateRange(const ReportFilter& filter, int firstDay, int lastDay) {
+    if (filter.fromDay == INT_MIN && filter.toDay == INT_MAX) {
+        return true;
+    }
+    if (firstDay < 0) firstDay = lastDay;
+    if (lastDay < 0) lastDay = firstDay;
+    return firstDay >= 0 && firstDay <= filter.toDay && lastDay >= filter.fromDay;
+}
+
+// Function to get the day a journal time (YYYY-MM-DD HH:MM:SS) falls on (-1 if there is none)
+int timeDay(string_view time) {
+    int day;
+    return (time.size() >= 10 && parseDay(time.substr(0, 10), day)) ? day : -1;
+}
+
+// Function to check the fields of a ledger index entry against a filter, before the row is read
+bool ledgerEntryMatches(const LedgerEntry& entry, const ReportFilter& filter, uint32_t guestHash) {
+    if (filter.roomNumber != 0 && entry.roomNumber != filter.roomNumber) return false;
+    if (!filter.guestName.empty() && entry.guestHash != guestHash) return false;
+    if (!filter.status.empty() && filter.status != "Checked Out" && filter.status != "No Show") return false;
+    return stayInDateRange(filter, entry.checkInDay, entry.checkOutDay);
+}
+
+// Function to decide how a report finds its ledger rows: by binary search in the keys of
+// its filter (room, guest, dates or no-shows), or in order when every row may match.
+// The entries the keys do not cover yet are always gone through in order afterwards.
+void planLedgerLookup(const LedgerIndexView& view, const ReportFilter& filter, ReportCursor& cursor) {
+    cursor.started = true;
+    if (!filter.status.empty() && filter.status != "Checked Out" && filter.status != "No Show") {
+        cursor.rowPosition = view.entryCount; // Only the journal has stays that are still open
+        return;
+    }
+    long long low = 0, high = 0;
+    if (filter.roomNumber != 0) {
+        cursor.keyKind = kRoomKey;
+        low = high = (uint32_t)filter.roomNumber;
+    } else if (!filter.guestName.empty()) {
+        cursor.keyKind = kGuestKey;
+        low = high = guestNameHash(filter.guestName);
+    } else if (filter.fromDay != INT_MIN || filter.toDay != INT_MAX) {
+        // A stay ends at most maxStayDays after it starts, so earlier starts cannot overlap
+        cursor.keyKind = kDayKey;
+        low = max((long long)filter.fromDay - view.maxStayDays, 0LL) + 1;
+        high = min((long long)filter.toDay, (long long)UINT32_MAX - 1) + 1;
+    } else if (filter.status == "No Show") {
+        cursor.keyKind = kDayKey; // No-shows have no days
+    }
+    if (cursor.keyKind < 0) {
+        return;
+    }
+    if (view.keyRows != 0 && low <= high) {
+        const LedgerKey* keys = view.keys[cursor.keyKind];
+        LedgerKey first = { (uint32_t)low, 0 };
+        LedgerKey last = { (uint32_t)high, UINT32_MAX };
+        cursor.keyPosition = lower_bound(keys, keys + view.keyRows, first, ledgerKeyBefore) - keys;
+        cursor.keyEnd = upper_bound(keys, keys + view.keyRows, last, ledgerKeyBefore) - keys;
+    }
+    cursor.rowPosition = view.keyRows;
+}
+
+// Function to write the next page of the customer report; returns the number of rows written.
+// Finished stays come from the ledger (through its index), then the stays still in the journal.
+size_t writeCustomerPage(CustomerStore& store, const LedgerIndexView& view, const ReportFilter& filter, ReportCursor& cursor,
+                         size_t pageSize, ReportWriter& writer, int ledgerFd) {
+    OperationTimer timer(store.timings[kOpCustomerReportPage]);
+    size_t rows = 0;
+    uint32_t guestHash = guestNameHash(filter.guestName);
+    string_view fields[kMaxFields];
+    if (!cursor.started) {
+        planLedgerLookup(view, filter, cursor);
+    }
+
+    string row;
+    while (rows < pageSize && (cursor.keyPosition < cursor.keyEnd || cursor.rowPosition < view.entryCount)) {
+        size_t position = (cursor.keyPosition < cursor.keyEnd) ? view.keys[cursor.keyKind][cursor.keyPosition++].row
+                                                               : cursor.rowPosition++;
+        const LedgerEntry& entry = view.entries[position];
+        if (!ledgerEntryMatches(entry, filter, guestHash)) {
+            continue;
+        }
+        row.resize(entry.length);
+        if (pread(ledgerFd, &row[0], row.size(), entry.offset) != (ssize_t)row.size()) {
+            continue;
+        }
+        ledgerRowFields(string_view(row).substr(0, row.size() - 1), fields); // Without the newline
+        string_view status = (fields[3] == "No Show") ? "No Show" : "Checked Out";
+        if ((!filter.guestName.empty() && !sameGuestName(fields[0], filter.guestName)) ||
+            (!filter.status.empty() && status != filter.status)) {
+            continue; // A hash collision, or a row whose dates did not parse
+        }
+        writeCustomerRow(writer, fields);
+        rows++;
+    }
+
+    map<long long, JournalBooking>::const_iterator it = store.bookings.lower_bound(cursor.nextBookingId);
+    for (; rows < pageSize && it != store.bookings.end(); ++it) {
+        const JournalBooking& booking = it->second;
+        cursor.nextBookingId = it->first + 1;
+        string_view status = booking.checkedOut ? "Checked Out"
+                             : !booking.checkInTime.empty() ? "Checked In"
+                             : booking.active ? "Booked" : "Reserved";
+        int firstDay = booking.checkInTime.empty() ? booking.arrivalDay : timeDay(booking.checkInTime);
+        int lastDay = booking.checkedOut ? timeDay(booking.checkOutTime) : booking.arrivalDay + booking.nights;
+        string payload;
+        if ((filter.roomNumber != 0 && booking.roomNumber != filter.roomNumber) ||
+            (!filter.status.empty() && status != filter.status) || !stayInDateRange(filter, firstDay, lastDay) ||
+            !readBookingRecord(store, booking, payload)) {
+            continue;
+        }
+        // B/R,id,room,name,contact,email,days,payment,arrivalDay
+        string_view record[kMaxFields];
+        if (tokenizeFields(payload, record, kMaxFields) < 8 ||
+            (!filter.guestName.empty() && !sameGuestName(record[3], filter.guestName))) {
+            continue;
+        }
+        string_view customer[7] = { record[3], record[2], booking.checkInTime, booking.checkOutTime, record[4], record[5],
+                                    record[6] };
+        writeCustomerRow(writer, customer);
+        rows++;
+    }
+    cursor.finished = cursor.keyPosition >= cursor.keyEnd && cursor.rowPosition >= view.entryCount && it == store.bookings.end();
+    return rows;
+}
+
+// Function to ask which customer rows to show; returns false if the answer is not valid
+bool readReportFilter(ReportFilter& filter) {
+    string choice;
+    cout << "\033[34mShow: 1. All  2. One Room  3. One Guest  4. Date Range  5. Status\nEnter your choice: \033[0m";
+    getline(cin, choice);
+    if (choice == "1" || choice.empty()) {
+        return true;
+    }
+    string input;
+    if (choice == "2") {
+        cout << "\033[34mEnter Room Number: \033[0m";
+        getline(cin, input);
+        return parseRoomNumber(input, filter.roomNumber) && filter.roomNumber != 0;
+    }
+    if (choice == "3") {
+        cout << "\033[34mEnter Guest Name: \033[0m";
+        getline(cin, filter.guestName);
+        return isValidCustomerName(filter.guestName);
+    }
+    if (choice == "4") {
+        string toDate;
+        cout << "\033[34mEnter From Date (YYYY-MM-DD): \033[0m";
+        getline(cin, input);
+        cout << "\033[34mEnter To Date (YYYY-MM-DD): \033[0m";
+        getline(cin, toDate);
+        return parseDay(input, filter.fromDay) && parseDay(toDate, filter.toDay) && filter.fromDay <= filter.toDay;
+    }
+    if (choice == "5") {
+        cout << "\033[34mEnter Status (Checked Out/No Show/Checked In/Booked/Reserved): \033[0m";
+        getline(cin, filter.status);
+        return filter.status == "Checked Out" || filter.status == "No Show" || filter.status == "Checked In" ||
+               filter.status == "Booked" || filter.status == "Reserved";
+    }
+    return false;
+}
 
+// Function to display customer details, one page at a time
+void displayCustomerDetails(CustomerStore& store) {
+    ReportFilter filter;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (!readReportFilter(filter)) {
+        cout << "\033[31mInvalid filter! Please try again.\033[0m" << endl;
+        return;
+    }
+    LedgerIndexView view;
+    if (!openLedgerIndexView(store, view)) {
+        return;
+    }
+    int ledgerFd = open(store.ledgerPath.c_str(), O_RDONLY);
+
+    ReportWriter writer;
+    writeText(writer, "\033[38;5;111mCustomer Details:\n");
+    writeText(writer, "-----------------------------------------------------------------------------------------------------------------------------------------------------------------\n");
+    ostringstream header;
+    header << setw(20) << "Customer Name" << setw(13) << "Room No" << setw(21) << "Check-in Time" << setw(27) << "Check-out Time"<< setw(26) << "Contact Number"
+           << setw(26) << "Email Address" << setw(20) << "Days Stay" << "\n";
+    writeText(writer, header.str());
+    writeText(writer, "------------------------------------------------------------------------------------------------------------------------------------------------------------------\033[0m\n");
+
+    ReportCursor cursor;
+    size_t shown = 0;
+    while (true) {
+        shown += writeCustomerPage(store, view, filter, cursor, kReportPageSize, writer, ledgerFd);
+        if (cursor.finished) {
+            break;
+        }
+        writeText(writer, "\033[38;5;223mPress Enter for the next page, or q to stop: \033[0m");
+        flushReport(writer);
+        string answer;
+        if (!getline(cin, answer) || answer == "q" || answer == "Q") {
+            break;
         }
-        file.close();
-    } else {
-        cout << "\033[31mNo customer data available!\033[0m" << endl;
     }
-     
-    
+    if (shown == 0) {
+        writeText(writer, "\033[31mNo customer data available!\033[0m\n");
+    }
+    flushReport(writer);
+    if (ledgerFd >= 0) {
+        close(ledgerFd);
+    }
+    closeLedgerIndexView(view);
 }
 
 
 
-// Simulating credit card validation function
-bool validateCreditCard(const string& cardNumber) {
-    // Simulate basic validation: check if the card number is 16 digits long
-    if (cardNumber.length() == 16) {
-        for (size_t i = 0; i < cardNumber.size(); ++i) {
-             char c = cardNumber[i];
-            if (!isdigit(c)) {
-                return false;  // Invalid if any character is not a digit
-            }
-        }
-        return true;
-    }
-    return false;
+// Simulating credit card validation function: 16 digits with a valid Luhn check digit
+bool validateCreditCard(string_view cardNumber) {
+    return cardNumber.length() == 16 && isAllDigits(cardNumber) && passesLuhn(cardNumber);
 }
 
 // Function to process the payment
-bool processPayment(const Room& room, int totalBill) {
-    string paymentMethod = room.paymentMethod;
+bool processPayment(const RoomTable& rooms, size_t slot, int totalBill) {
+    string paymentMethod = kPaymentMethods[rooms.guest[slot].paymentMethod];
 
     if (paymentMethod == "Cash") {
         cout << "\033[32mPlease pay the total bill amount of Rs. " << totalBill << " in cash.\033[0m" << endl;
@@ -464,22 +2842,22 @@ bool processPayment(const Room& room, int totalBill) {
 
 
 // Function to generate the bill
-void generateBill(const Room& room, int days) {
-    if (!room.isBooked) {
-        cout << "\033[31mRoom " << room.roomNumber << " is not booked. No bill to generate.\033[0m" << endl;
+void generateBill(const RoomTable& rooms, size_t slot, int days) {
+    if (!rooms.isBooked[slot]) {
+        cout << "\033[31mRoom " << rooms.roomNumber[slot] << " is not booked. No bill to generate.\033[0m" << endl;
         return;
     }
     
-    int totalBill = room.pricePerDay * days;
+    int totalBill = rooms.pricePerDay[slot] * days;
 
     cout << "\n\033[38;5;112mBilling Details:\033[0m" << endl;
-    cout << "\033[32mCustomer Name: \033[0m" << room.customerName << endl;
-    cout << "\033[32mRoom Number: \033[0m" << room.roomNumber << endl;
-    cout << "\033[32mRoom Type: \033[0m" << room.type << endl;
-    cout << "\033[32mPrice Per Day: Rs. \033[0m" << room.pricePerDay << endl;
+    cout << "\033[32mCustomer Name: \033[0m" << roomText(rooms, rooms.guest[slot].customerName) << endl;
+    cout << "\033[32mRoom Number: \033[0m" << rooms.roomNumber[slot] << endl;
+    cout << "\033[32mRoom Type: \033[0m" << rooms.typeNames[rooms.typeId[slot]] << endl;
+    cout << "\033[32mPrice Per Day: Rs. \033[0m" << rooms.pricePerDay[slot] << endl;
     cout << "\033[32mNumber of Days: \033[0m" << days << endl;
     cout << "\033[38;5;214mTotal Bill: Rs. \033[0m" << totalBill << endl;
-    cout << "\033[32mPayment Method: \033[0m" << room.paymentMethod << endl;
+    cout << "\033[32mPayment Method: \033[0m" << kPaymentMethods[rooms.guest[slot].paymentMethod] << endl;
 
      
 }
@@ -488,7 +2866,7 @@ void generateBill(const Room& room, int days) {
 
 
 // Function to handle check-in
-void checkInRoom(vector<Room>& rooms) {
+void checkInRoom(RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar, CustomerStore& store) {
     int roomNumber;
     string numberOfDays;
     cout << "\033[38;5;141mEnter Room Number to Check In: \033[0m";
@@ -497,46 +2875,50 @@ void checkInRoom(vector<Room>& rooms) {
             throw invalid_argument("\033[31mInvalid input! Please enter a valid room number (integer).\033[0m");
         }
 
-        for (size_t i = 0; i < rooms.size(); ++i) {
-            Room& room = rooms[i];
-            if (room.roomNumber == roomNumber) {
-                if (!room.isBooked) {
-                    cout << "\033[34mRoom " << roomNumber << " is not booked yet!\033[0m" << endl;
-                } else {
-                    if (room.checkInTime.empty()) {
-                           // Convert numberOfDays from string to integer here
-                        int days = 0;
-                        try {
-                            days = stoi(room.numberOfDays);  // Convert to integer
-                            if (days <= 0) {
-                                throw invalid_argument("\033[31mNumber of days must be a positive integer!\033[0m");
-                            }
-                        } catch (const std::invalid_argument& e) {
-                            cout << "\033[31mInvalid number of days: " << room.numberOfDays << ". Please enter a valid positive integer.\033[0m" << endl;
-                            return;
-                        }
-                         generateBill(room, days);
-                        room.checkInTime = getCurrentTime();  // Set check-in time when the guest checks in
-                        bool paymentSuccessful = processPayment(room, room.pricePerDay * days);  // Check payment status
-
-                        if (paymentSuccessful) {
-                          
-                            cout << "\033[32mRoom " << roomNumber << " has been checked-in successfully at " << room.checkInTime << "!\033[0m" << endl;
-                            // Update check-in time in the file
-                            updateCheckInTime("CustomerData.txt", roomNumber, room.checkInTime);
-                        } else {
-                            cout << "\033[31mCheck-in failed due to payment failure.\033[0m" << endl;
-                            room.checkInTime.clear();
-                        }
-                        
-                    } else {
-                        cout << "\033[34mRoom " << roomNumber << " is already checked-in.\033[0m" << endl;
-                    }
+        size_t slot = findRoomSlot(inventory, roomNumber);
+        if (slot == kNoRoom) {
+            cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
+            return;
+        }
+        RoomGuest& guest = rooms.guest[slot];
+
+        // A guest with a reservation for tonight takes the room on arrival
+        if (!rooms.isBooked[slot] && activateReservation(rooms, inventory, calendar, store, slot)) {
+            cout << "\033[32mWelcome, " << roomText(rooms, guest.customerName) << "! Your reservation for Room "
+                 << roomNumber << " is now active.\033[0m" << endl;
+        }
+        if (!rooms.isBooked[slot]) {
+            cout << "\033[34mRoom " << roomNumber << " is not booked yet!\033[0m" << endl;
+        } else if (guest.checkInTime.length == 0) {
+            // Convert numberOfDays from string to integer here
+            int days = 0;
+            numberOfDays = string(roomText(rooms, guest.numberOfDays));
+            try {
+                days = stoi(numberOfDays);  // Convert to integer
+                if (days <= 0) {
+                    throw invalid_argument("\033[31mNumber of days must be a positive integer!\033[0m");
                 }
+            } catch (const std::invalid_argument& e) {
+                cout << "\033[31mInvalid number of days: " << numberOfDays << ". Please enter a valid positive integer.\033[0m" << endl;
                 return;
             }
+            generateBill(rooms, slot, days);
+            string checkInTime = getCurrentTime();  // Set check-in time when the guest checks in
+            bool paymentSuccessful = processPayment(rooms, slot, rooms.pricePerDay[slot] * days);  // Check payment status
+
+            if (paymentSuccessful) {
+                string error = completeCheckIn(rooms, store, slot, checkInTime);
+                if (error.empty()) {
+                    cout << "\033[32mRoom " << roomNumber << " has been checked-in successfully at " << checkInTime << "!\033[0m" << endl;
+                } else {
+                    cout << "\033[31m" << error << "\033[0m" << endl;
+                }
+            } else {
+                cout << "\033[31mCheck-in failed due to payment failure.\033[0m" << endl;
+            }
+        } else {
+            cout << "\033[34mRoom " << roomNumber << " is already checked-in.\033[0m" << endl;
         }
-        cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
     } catch (const invalid_argument& e) {
         cout << e.what() << endl;
         cin.clear();
@@ -546,13 +2928,9 @@ void checkInRoom(vector<Room>& rooms) {
 
 // Function to check out a room
 
-void checkOutRoom(vector<Room>& rooms) 
+void checkOutRoom(RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar, CustomerStore& store)
 {
     int roomNumber;
-    string customerName;
-    string contactNumber;
-    string emailAddress;
-    string numberOfDays;
    
 
     try
@@ -562,37 +2940,16 @@ void checkOutRoom(vector<Room>& rooms)
             throw invalid_argument("\033[31mInvalid input! Please enter a valid room number (integer).\033[0m");
         }
 
-    for (size_t i = 0; i < rooms.size(); ++i)
-    {
-    Room& room = rooms[i];
-        if (room.roomNumber == roomNumber) {
-            if (!room.isBooked) {
-                cout << "\033[34mRoom " << roomNumber << " is already free!" << endl;
-            } else {
-                room.isBooked = false;
-                room.checkOutTime = getCurrentTime();
-                updateCheckOutTime("CustomerData.txt", roomNumber, room.checkOutTime);
-
-
-
-                cout << "\033[32mRoom " << roomNumber << " has been checked out successfully!\033[0m" << endl;
-
-            
-
-                // Reset room details
-                room.customerName = "";
-                room.checkInTime = "";
-                room.checkOutTime = "";
-                contactNumber ="";
-                emailAddress = "";
-                numberOfDays="";
-               
-            }
-            return;
+        size_t slot = findRoomSlot(inventory, roomNumber);
+        if (slot == kNoRoom) {
+            cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
+        } else if (!rooms.isBooked[slot]) {
+            cout << "\033[34mRoom " << roomNumber << " is already free!" << endl;
+        } else if (completeCheckOut(rooms, inventory, calendar, store, slot).empty()) {
+            cout << "\033[32mRoom " << roomNumber << " has been checked out successfully!\033[0m" << endl;
+        } else {
+            cout << "\033[31mError: Could not write to the customer journal.\033[0m" << endl;
         }
-    }
-    
-      cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
     } catch (const invalid_argument& e) {
         cout << e.what() << endl;
         cin.clear();
@@ -605,45 +2962,86 @@ void checkOutRoom(vector<Room>& rooms)
 
 
 // Function to generate and display the summary report of bookings and room statuses
-void generateSummaryReport(const vector<Room>& rooms) {
+void generateSummaryReport(const RoomTable& rooms, const RoomInventory& inventory, CustomerStore& store, ostream& out = cout) {
+    OperationTimer timer(store.timings[kOpSummaryReport]);
 
     const string red = "\033[31m";   // Red text
     const string green = "\033[32m"; // Green text
     
     const string reset = "\033[0m";  // Reset to default color
  try {
-    cout << "\n  \t  \t     \t   \t     \033[38;5;214m     Summary Report of Bookings and Room Statuses \n";
-    cout << "\033[38;5;214m--------------------------------------------------------------------------------------------------------------------------------------------\n";
-    cout << setw(25) << "Guest Name" 
+    ReportWriter writer;
+    writer.out = &out;
+    ostringstream text;
+
+    if (store.uncountedLedgerBytes > 0) {
+        countLedgerCheckIns(store, inventory);
+    }
+
+    // Occupancy comes from the inventory counters and the rest from the running totals,
+    // so this part costs the same however many rooms and however long a history the hotel has
+    const vector<int>& roomsOfType = inventory.roomCount;
+    int booked = 0;
+    for (size_t type = 0; type < roomsOfType.size(); ++type) {
+        booked += roomsOfType[type] - countFreeRooms(inventory, type);
+    }
+    text << "\n\033[38;5;223mOccupancy:\033[0m " << booked << " of " << rooms.roomNumber.size() << " rooms booked ("
+         << fixed << setprecision(1) << (rooms.roomNumber.empty() ? 0.0 : 100.0 * booked / rooms.roomNumber.size()) << "%)\n";
+    for (size_t type = 0; type < roomsOfType.size(); ++type) {
+        long long revenue = (type < store.totals.revenueByType.size()) ? store.totals.revenueByType[type] : 0;
+        text << "  \033[34m" << setw(8) << left << rooms.typeNames[type] << right << "\033[0m"
+             << setw(4) << roomsOfType[type] - countFreeRooms(inventory, type) << " / " << setw(3) << roomsOfType[type]
+             << " booked    Revenue: Rs. " << revenue << "\n";
+    }
+    text << "\033[38;5;223mCheck-ins:\033[0m " << store.totals.stays << "    \033[38;5;223mNights billed:\033[0m "
+         << store.totals.nights << "    \033[38;5;223mAverage stay:\033[0m "
+         << (store.totals.stays == 0 ? 0.0 : (double)store.totals.nights / store.totals.stays) << " nights\n";
+    text.unsetf(ios::floatfield);
+    writeText(writer, text.str());
+
+    text.str("");
+    text << "\n  \t  \t     \t   \t     \033[38;5;214m     Summary Report of Bookings and Room Statuses \n";
+    text << "\033[38;5;214m--------------------------------------------------------------------------------------------------------------------------------------------\n";
+    text << setw(25) << "Guest Name" 
          << setw(25) << "Room Number " 
          << setw(25) << "   Room Type " 
          << setw(25) << "  Status " 
-         << setw(30) << "  Check-In Time  " << endl;
-    cout << "--------------------------------------------------------------------------------------------------------------------------------------------\033[0m\n";
+         << setw(30) << "  Check-In Time  " << "\n";
+    text << "--------------------------------------------------------------------------------------------------------------------------------------------\033[0m\n";
+    writeText(writer, text.str());
 
-    for (size_t i = 0; i < rooms.size(); ++i) 
+    // Only booked rooms touch the guest columns; the rest comes from the dense hot columns.
+    // The rows are collected in the writer and reach the screen in a few large writes.
+    for (size_t i = 0; i < rooms.roomNumber.size(); ++i) 
     {
-    const Room& room = rooms[i];
-
-        string status = room.isBooked ? red + "Booked" + reset : green + "Available" + reset;
-        string roomtype = "\033[34m" + room.type + "\033[0m"; // Blue for "Room Type"
-        string roomcustomerName = "\033[33m" + room.customerName + "\033[0m"; // Yellow for "Guest Name"
-
-        
-
-        cout <<std::right
-             << setw(30) << roomcustomerName 
-             << setw(25) << room.roomNumber 
-             << setw(36) << roomtype
-             << setw(38) << status
-             << setw(36) << (room.isBooked ? room.checkInTime : "") << std::flush << endl;
+        bool isBooked = rooms.isBooked[i] != 0;
+        char roomNumber[16];
+        snprintf(roomNumber, sizeof(roomNumber), "%d", rooms.roomNumber[i]);
+
+        writeColumn(writer, isBooked ? roomText(rooms, rooms.guest[i].customerName) : "", 30, "\033[33m"); // Yellow for "Guest Name"
+        writeColumn(writer, roomNumber, 25);
+        writeColumn(writer, rooms.typeNames[rooms.typeId[i]], 36, "\033[34m"); // Blue for "Room Type"
+        if (isBooked) {
+            writeColumn(writer, "Booked", 38, red.c_str());
+        } else {
+            writeColumn(writer, "Available", 38, green.c_str());
+        }
+        writeColumn(writer, isBooked ? roomText(rooms, rooms.guest[i].checkInTime) : "", 36);
+        writeText(writer, "\n");
     }
-    cout << "\033[38;5;214m--------------------------------------------------------------------------------------------------------------------------------------------\033[0m\n";
+    writeText(writer, "\033[38;5;214m--------------------------------------------------------------------------------------------------------------------------------------------\033[0m\n");
+    flushReport(writer);
 }
 catch (const runtime_error& e) {
         cout << e.what() << endl;
     }
 }
+
+// Function to display how long the operations of this session took
+void displayOperationTimings(const CustomerStore& store) {
+    cout << "\n\033[38;5;223mOperation Timings (this session):\033[0m\n" << formatOperationTimings(store.timings);
+    cout << "\033[38;5;223mp50/p99 are estimated from power-of-two latency buckets.\033[0m" << endl;
+}
         
 // Main menu
 void displayMenu() {
@@ -655,40 +3053,919 @@ void displayMenu() {
     cout << "\033[38;5;114m5. \033[38;5;17m Display Customer Details" << endl;
     cout << "\033[38;5;114m6. \033[38;5;17m Check Out Room" << endl;
     cout << "\033[38;5;114m7. \033[38;5;17m Summary Report of all bookings" << endl;
-    cout << "\033[38;5;114m8. \033[38;5;17m Exit \033[0m\n" << endl;
+    cout << "\033[38;5;114m8. \033[38;5;17m Search Free Rooms by Date" << endl;
+    cout << "\033[38;5;114m9. \033[38;5;17m Operation Timings" << endl;
+    cout << "\033[38;5;114m10.\033[38;5;17m Exit \033[0m\n" << endl;
     cout << "\033[35mEnter your choice :\033[0m";
 }
 
  
-int main() {
-    
-    vector<Room> rooms;
+// Function to create the hotel's rooms with their default layout
+RoomTable createRooms() {
+    RoomTable rooms;
 
-    rooms.reserve(100); // Reserve memory for 100 rooms
+    rooms.roomNumber.reserve(100); // Reserve memory for 100 rooms
+    uint32_t amenities = internAmenity(rooms, "A/C") | internAmenity(rooms, "Geyser") | internAmenity(rooms, "TV") |
+                         internAmenity(rooms, "Free WiFi");
     for (int i = 0; i < 100; i++) {
         string roomType = (i < 30) ? "Single" : (i < 60) ? "Double" : "Suite"; // Assigning room types based on room number
-        rooms.emplace_back(i + 1, false, "", roomType);
-        
-        rooms[i].roomNumber = i + 1;
-        rooms[i].isBooked = false;
-        rooms[i].customerName = "";
-        
-        rooms[i].pricePerDay = (i < 5) ? 1500 : 2500;
-        
-         
-         // Manually assign values to the amenities vectors
-        rooms[i].amenities.resize(4);  // Ensure the vector has space for 4 elements
-        rooms[i].amenities[0] = "\033[38;5;214mA/C";
-        rooms[i].amenities[1] = "\033[38;5;214mGeyser";
-        rooms[i].amenities[2] = "\033[38;5;214mTV";
-        rooms[i].amenities[3] = "\033[38;5;214mFree WiFi\033[0m";
+        addRoom(rooms, i + 1, roomType, (i < 5) ? 1500 : 2500, amenities);
+    }
+
+    return rooms;
+}
+
+// ---------------------------------------------------------------------------
+// Batch mode
+//
+// `--batch FILE` (or `--batch -` for stdin) applies one command per line, with no
+// menu or prompts:
+//   book,ROOM,NAME,CONTACT,EMAIL,DAYS,Cash|Credit[,YYYY-MM-DD]
+//   checkin,ROOM
+//   checkout,ROOM
+//   report
+// Blank lines and lines starting with '#' are skipped. Check-in takes no payment,
+// as batch input is expected to be settled already. Commands are applied in batches
+// of kBatchSize, each made durable with a single journal write. Output goes to
+// stdout: "room,..." rows for each report and an "error,LINE,REASON" row for every
+// command that was refused. A summary goes to stderr.
+// ---------------------------------------------------------------------------
+
+const int kBatchSize = 4096; // Commands per durable journal write in batch mode
+
+// Function to add the status of every room to the batch output
+void appendRoomReport(const RoomTable& rooms, string& output) {
+    for (size_t i = 0; i < rooms.roomNumber.size(); ++i) {
+        bool isBooked = rooms.isBooked[i] != 0;
+        output += "room," + to_string(rooms.roomNumber[i]) + "," + rooms.typeNames[rooms.typeId[i]] + ",";
+        output += isBooked ? "Booked," : "Available,";
+        if (isBooked) {
+            output += roomText(rooms, rooms.guest[i].customerName);
+            output += ",";
+            output += roomText(rooms, rooms.guest[i].checkInTime);
+        } else {
+            output += ",";
+        }
+        output += "\n";
+    }
+}
+
+// Function to apply one batch command
+string runBatchCommand(RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar, CustomerStore& store,
+                       const string_view* fields, size_t fieldCount, string& output) {
+    string command(fields[0]);
+    if (command == "book") {
+        if (fieldCount != 7 && fieldCount != 8) {
+            return "book expects ROOM,NAME,CONTACT,EMAIL,DAYS,PAYMENT[,ARRIVAL DATE]";
+        }
+        BookingRequest request = { 0, string(fields[2]), string(fields[3]), string(fields[4]), string(fields[5]),
+                                   string(fields[6]), currentDay() };
+        if (!parseRoomNumber(fields[1], request.roomNumber)) {
+            return "Invalid room number: " + string(fields[1]);
+        }
+        if (fieldCount == 8 && !parseDay(fields[7], request.arrivalDay)) {
+            return "Invalid date! Enter the date as YYYY-MM-DD.";
+        }
+        string error = bookingRequestError(request);
+        return error.empty() ? placeBooking(rooms, inventory, calendar, store, request) : error;
+    }
+    if (command == "checkin" || command == "checkout") {
+        int roomNumber;
+        if (fieldCount != 2 || !parseRoomNumber(fields[1], roomNumber)) {
+            return command + " expects a room number";
+        }
+        size_t slot = findRoomSlot(inventory, roomNumber);
+        if (slot == kNoRoom) {
+            return "Room " + string(fields[1]) + " does not exist!";
+        }
+        if (command == "checkout") {
+            return completeCheckOut(rooms, inventory, calendar, store, slot);
+        }
+        if (!rooms.isBooked[slot]) {
+            activateReservation(rooms, inventory, calendar, store, slot);
+        }
+        return completeCheckIn(rooms, store, slot, getCurrentTime());
+    }
+    if (command == "report" && fieldCount == 1) {
+        appendRoomReport(rooms, output);
+        return "";
+    }
+    return "Unknown command: " + command;
+}
+
+// Function to run the commands of a file (or stdin for "-") against the customer store
+int runBatch(const string& path) {
+    ifstream file;
+    if (path != "-") {
+        file.open(path.c_str());
+        if (!file) {
+            cerr << "Error: Could not open " << path << "." << endl;
+            return 1;
+        }
+    }
+    istream& input = (path == "-") ? cin : file;
+    ios::sync_with_stdio(false);
+
+    RoomTable rooms = createRooms();
+    CustomerStore store;
+    if (!openCustomerStore(store, "CustomerData.txt", rooms)) {
+        return 1;
+    }
+    RoomInventory inventory;
+    buildRoomInventory(inventory, rooms);
+    ReservationCalendar calendar;
+    buildReservationCalendar(calendar, rooms, currentDay());
+    loadReservations(calendar, inventory, store);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    string line;
+    string_view fields[kMaxFields];
+    string output; // Report and error rows of the current batch, written once it is durable
+    long long lineNumber = 0;
+    long long applied = 0;
+    long long failed = 0;
+    int inBatch = 0;
+    bool moreInput = true;
+    while (moreInput) {
+        beginJournalBatch(store);
+        inBatch = 0;
+        while (inBatch < kBatchSize && (moreInput = static_cast<bool>(getline(input, line)))) {
+            ++lineNumber;
+            if (!line.empty() && line[line.size() - 1] == '\r') {
+                line.erase(line.size() - 1);
+            }
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            size_t fieldCount = tokenizeFields(line, fields, kMaxFields);
+            string error = runBatchCommand(rooms, inventory, calendar, store, fields, fieldCount, output);
+            if (error.empty()) {
+                ++applied;
+            } else {
+                ++failed;
+                output += "error," + to_string(lineNumber) + "," + error + "\n";
+            }
+            ++inBatch;
+        }
+        if (!commitJournalBatch(store)) {
+            cerr << "Error: Could not write to the customer journal. Commands up to line " << lineNumber
+                 << " were not saved." << endl;
+            return 1;
+        }
+        cout << output;
+        output.clear();
+    }
+    cout.flush();
+    closeCustomerStore(store);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << applied + failed << " commands (" << applied << " applied, " << failed << " failed) in " << fixed
+         << setprecision(1) << seconds * 1000 << " ms, " << setprecision(0) << (applied + failed) / max(seconds, 1e-9)
+         << " commands/s" << endl;
+    cerr << formatOperationTimings(store.timings);
+    return failed == 0 ? 0 : 2;
+}
+
+// ---------------------------------------------------------------------------
+// Hotel service
+//
+// Lets several threads (front desk, online channel, housekeeping) book, check in
+// and check out at the same time. Each room has its own lock, held for the whole
+// operation on that room, so two bookings of one room can never both pass the
+// availability check. The structures rooms share (guest arena, free-room and
+// calendar bitsets, journal index) are changed under one short state lock.
+// Journal records are queued, and a single writer thread writes everything
+// queued so far with one write and one fsync (group commit). An operation
+// returns once its records are durable, without holding a lock while it waits.
+// Lock order: room lock, then state lock.
+// ---------------------------------------------------------------------------
+
+struct HotelService {
+    RoomTable* rooms;
+    RoomInventory* inventory;
+    ReservationCalendar* calendar;
+    CustomerStore* store;
+    vector<mutex> roomLocks;             // One per room slot
+    mutex stateMutex;                    // Everything shared between rooms, and the fields below
+    condition_variable journalQueued;    // Wakes the writer
+    condition_variable journalWritten;   // Wakes operations waiting for their records
+    long long nextCommit;                // Commit that will take the records queued now
+    long long lastCommit;                // Last commit that is durable
+    bool failed;                         // A journal write failed; no more changes are accepted
+    bool stopping;
+    thread writer;
+
+    HotelService() : rooms(NULL), inventory(NULL), calendar(NULL), store(NULL), nextCommit(1), lastCommit(0), failed(false),
+                     stopping(false) {}
+};
+
+// Function run by the writer thread: commits queued journal records until the service stops
+void runJournalWriter(HotelService& service) {
+    CustomerStore& store = *service.store;
+    unique_lock<mutex> lock(service.stateMutex);
+    while (true) {
+        service.journalQueued.wait(lock, [&service, &store] { return !store.pendingJournal.empty() || service.stopping; });
+        if (store.pendingJournal.empty()) {
+            return; // Stopping, and everything is written
+        }
+        // The queued records stay in pendingJournal while they are written, so they can still be read back
+        string records = store.pendingJournal;
+        long long durableBytes = store.journalBytes - store.pendingJournal.size();
+        long long commit = service.nextCommit++;
+        lock.unlock();
+        bool written = syncJournal(store, records);
+        lock.lock();
+        if (!written) {
+            if (ftruncate(store.journalFd, durableBytes) != 0) {
+                cout << "\033[31mError: Could not repair the customer journal.\033[0m" << endl;
+            }
+            service.failed = true;
+            service.journalWritten.notify_all();
+            return;
+        }
+        store.pendingJournal.erase(0, records.size());
+
+        // Compaction rewrites the journal, so it runs here with the state lock held,
+        // after writing out (as one more commit) anything queued in the meantime
+        if (compactionDue(store)) {
+            if (!flushJournalBatch(store)) {
+                service.failed = true;
+                service.journalWritten.notify_all();
+                return;
+            }
+            commit = service.nextCommit++;
+            compactCustomerStore(store); // On failure the journal is left as it was
+        }
+        service.lastCommit = commit;
+        service.journalWritten.notify_all();
+    }
+}
+
+// Function to start the service over an opened store and the rooms it restored
+void startHotelService(HotelService& service, RoomTable& rooms, RoomInventory& inventory, ReservationCalendar& calendar,
+                       CustomerStore& store) {
+    service.rooms = &rooms;
+    service.inventory = &inventory;
+    service.calendar = &calendar;
+    service.store = &store;
+    vector<mutex>(rooms.roomNumber.size()).swap(service.roomLocks);
+    beginJournalBatch(store);
+    service.writer = thread(runJournalWriter, ref(service));
+}
+
+// Function to stop the service once every queued record is written
+void stopHotelService(HotelService& service) {
+    {
+        lock_guard<mutex> lock(service.stateMutex);
+        service.stopping = true;
+    }
+    service.journalQueued.notify_one();
+    service.writer.join();
+    service.store->batching = false;
+}
+
+// Function to finish an operation: if it queued journal records, wait until they are durable.
+// Called with the state lock held; the room lock must already be released.
+string finishServiceOperation(HotelService& service, unique_lock<mutex>& lock, long long journalBytesBefore,
+                              const string& error) {
+    if (service.store->journalBytes == journalBytesBefore) {
+        return error;
+    }
+    long long commit = service.nextCommit;
+    service.journalQueued.notify_one();
+    service.journalWritten.wait(lock, [&service, commit] { return service.lastCommit >= commit || service.failed; });
+    return service.lastCommit >= commit ? error : "Could not write to the customer journal.";
+}
+
+// Function to book a room through the service
+string serviceBookRoom(HotelService& service, const BookingRequest& request) {
+    string error = bookingRequestError(request);
+    if (!error.empty()) {
+        return error;
+    }
+    size_t slot = findRoomSlot(*service.inventory, request.roomNumber);
+    if (slot == kNoRoom) {
+        return "Room " + to_string(request.roomNumber) + " does not exist!";
+    }
+    unique_lock<mutex> roomLock(service.roomLocks[slot]);
+    // A room's booked flag and reservations only change under its own lock, so this check
+    // needs no other lock, and no other thread can take the room before it is booked below
+    int endDay = request.arrivalDay + stoi(request.numberOfDays);
+    if ((request.arrivalDay == currentDay() && service.rooms->isBooked[slot]) ||
+        hasReservationConflict(*service.calendar, slot, request.arrivalDay, endDay)) {
+        return "Room " + to_string(request.roomNumber) + " is already booked for those dates!";
+    }
+    unique_lock<mutex> lock(service.stateMutex);
+    if (service.failed) {
+        return "Could not write to the customer journal.";
+    }
+    long long journalBytes = service.store->journalBytes;
+    error = placeBooking(*service.rooms, *service.inventory, *service.calendar, *service.store, request);
+    roomLock.unlock();
+    return finishServiceOperation(service, lock, journalBytes, error);
+}
+
+// Function to check in a room through the service. A Credit booking needs a valid card number.
+string serviceCheckInRoom(HotelService& service, int roomNumber, const string& cardNumber) {
+    size_t slot = findRoomSlot(*service.inventory, roomNumber);
+    if (slot == kNoRoom) {
+        return "Room " + to_string(roomNumber) + " does not exist!";
+    }
+    unique_lock<mutex> roomLock(service.roomLocks[slot]);
+    unique_lock<mutex> lock(service.stateMutex);
+    if (service.failed) {
+        return "Could not write to the customer journal.";
+    }
+    RoomTable& rooms = *service.rooms;
+    long long journalBytes = service.store->journalBytes;
+    if (!rooms.isBooked[slot]) {
+        activateReservation(rooms, *service.inventory, *service.calendar, *service.store, slot);
+    }
+    string error;
+    if (rooms.isBooked[slot] && rooms.guest[slot].checkInTime.length == 0 &&
+        string(kPaymentMethods[rooms.guest[slot].paymentMethod]) == "Credit" && !validateCreditCard(cardNumber)) {
+        error = "Payment failed. Invalid card number.";
+    } else {
+        error = completeCheckIn(rooms, *service.store, slot, getCurrentTime());
+    }
+    roomLock.unlock();
+    return finishServiceOperation(service, lock, journalBytes, error);
+}
+
+// Function to check out a room through the service
+string serviceCheckOutRoom(HotelService& service, int roomNumber) {
+    size_t slot = findRoomSlot(*service.inventory, roomNumber);
+    if (slot == kNoRoom) {
+        return "Room " + to_string(roomNumber) + " does not exist!";
+    }
+    unique_lock<mutex> roomLock(service.roomLocks[slot]);
+    unique_lock<mutex> lock(service.stateMutex);
+    if (service.failed) {
+        return "Could not write to the customer journal.";
+    }
+    long long journalBytes = service.store->journalBytes;
+    string error = completeCheckOut(*service.rooms, *service.inventory, *service.calendar, *service.store, slot);
+    roomLock.unlock();
+    return finishServiceOperation(service, lock, journalBytes, error);
+}
+
+// Function to book a room, check it in and (optionally) check it out without prompts, for benchmarks
+void runBenchmarkStay(CustomerStore& store, RoomTable& rooms, size_t slot, bool checkOut) {
+    RoomGuest& guest = rooms.guest[slot];
+    BookingRequest request = { rooms.roomNumber[slot], "Bench Guest", "03001234567", "guest@example.com", "2", "Cash", currentDay() };
+    occupyRoom(rooms, slot, request);
+    recordBooking(store, request, true);
+
+    string checkInTime = getCurrentTime();
+    setRoomText(rooms, guest.checkInTime, checkInTime);
+    updateCheckInTime(store, rooms.roomNumber[slot], checkInTime);
+
+    if (checkOut) {
+        string checkOutTime = getCurrentTime();
+        rooms.isBooked[slot] = 0;
+        clearRoomGuest(rooms, slot);
+        updateCheckOutTime(store, rooms.roomNumber[slot], checkOutTime);
+        maybeCompactCustomerStore(store);
+    }
+}
+
+// Function to create a hotel of any size for benchmarks, with the three room types taking turns
+RoomTable createBenchmarkRooms(size_t roomCount) {
+    const char* types[] = { "Single", "Double", "Suite" };
+    RoomTable rooms;
+    uint32_t amenities = internAmenity(rooms, "A/C") | internAmenity(rooms, "Geyser") | internAmenity(rooms, "TV") |
+                         internAmenity(rooms, "Free WiFi");
+    for (size_t i = 0; i < roomCount; ++i) {
+        addRoom(rooms, i + 1, types[i % 3], 2500, amenities);
+    }
+    return rooms;
+}
+
+// Function to write a ledger of finished stays spread over the given number of rooms, for benchmarks
+bool writeSyntheticLedger(const string& ledgerPath, long long rows, size_t roomCount) {
+    ofstream ledger(ledgerPath, ios::binary);
+    string buffer;
+    for (long long i = 0; i < rows; ++i) {
+        buffer += "Guest " + to_string(i) + "," + to_string(i % roomCount + 1) + ",2024-01-01 12:00:00,2024-01-03 11:00:00,03001234567,guest" +
+                  to_string(i) + "@example.com,2\n";
+        if (buffer.size() >= (1 << 20)) {
+            ledger << buffer;
+            buffer.clear();
+        }
+    }
+    ledger << buffer;
+    return static_cast<bool>(ledger);
+}
+
+// Function to delete the files of a store (and any half-written replacements), for the benchmarks and tests
+void removeStoreFiles(const string& ledgerPath) {
+    const char* const suffixes[] = { ".journal", ".snapshot", ".idx", ".keys" };
+    unlink(ledgerPath.c_str());
+    for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); ++i) {
+        string path = siblingPath(ledgerPath, suffixes[i]);
+        unlink(path.c_str());
+        unlink((path + ".tmp").c_str());
+    }
+}
+
+// Function to measure the room table's memory and scan speed (run with --bench-rooms [rooms])
+int runRoomTableBenchmark(long long roomCount) {
+    if (roomCount <= 0) {
+        cerr << "Usage: --bench-rooms [rooms]" << endl;
+        return 1;
+    }
+    RoomTable rooms = createBenchmarkRooms(roomCount);
+    // Half of the rooms get a guest
+    for (size_t i = 0; i < (size_t)roomCount; i += 2) {
+        RoomGuest& guest = rooms.guest[i];
+        rooms.isBooked[i] = 1;
+        setRoomText(rooms, guest.customerName, "Guest Number " + to_string(i));
+        setRoomText(rooms, guest.contactNumber, "03001234567");
+        setRoomText(rooms, guest.emailAddress, "guest" + to_string(i) + "@example.com");
+        setRoomText(rooms, guest.numberOfDays, "3");
+        setRoomText(rooms, guest.checkInTime, "2026-10-18 10:00:00");
+        guest.paymentMethod = paymentMethodId("Cash");
+    }
+
+    cout << "Rooms: " << roomCount << " (half booked)" << endl;
+    cout << "Room table: " << fixed << setprecision(1) << (double)roomTableBytes(rooms) / roomCount << " bytes per room, "
+         << sizeof(int) + 2 << " of them in the hot columns" << endl;
+
+    // The scans behind the summary report and the availability view
+    const int runs = 20;
+    size_t booked[256] = { 0 };
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int run = 0; run < runs; ++run) {
+        for (size_t i = 0; i < (size_t)roomCount; ++i) {
+            booked[rooms.typeId[i]] += rooms.isBooked[i];
+        }
+    }
+    double scanNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / runs / roomCount;
+    cout << "Booked-per-type scan: " << setprecision(2) << scanNs << " ns per room (" << booked[0] / runs << " Single booked)" << endl;
+    return 0;
+}
+
+// Function to time startup against a large synthetic history (run with --bench-startup [records])
+int runStartupBenchmark(long long historyRecords) {
+    char directory[] = "/tmp/hotel-bench-XXXXXX";
+    if (mkdtemp(directory) == NULL) {
+        cout << "Error: Could not create a benchmark directory." << endl;
+        return 1;
+    }
+    string ledgerPath = string(directory) + "/CustomerData.txt";
+
+    // The history: finished stays already compacted into the ledger
+    if (!writeSyntheticLedger(ledgerPath, historyRecords, 100)) {
+        cout << "Error: Could not write " << ledgerPath << "." << endl;
+        removeStoreFiles(ledgerPath);
+        rmdir(directory);
+        return 1;
+    }
+
+    cout << "History: " << historyRecords << " records, " << fileSize(ledgerPath) / (1024 * 1024) << " MB ledger" << endl;
+
+    // What a startup that replays the full history would have to read at the very least
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ifstream history(ledgerPath);
+    string line;
+    long long lines = 0;
+    while (getline(history, line)) {
+        ++lines;
+    }
+    history.close();
+    double scanMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "Reading the full history:           " << fixed << setprecision(2) << scanMs << " ms (" << lines << " lines)" << endl;
+
+    const int changeCounts[] = { 0, 100, 1000 };
+    for (size_t c = 0; c < sizeof(changeCounts) / sizeof(changeCounts[0]); ++c) {
+        // Leave a snapshot with some occupied rooms, then write changes after it without compacting
+        RoomTable rooms = createRooms();
+        CustomerStore store;
+        if (!openCustomerStore(store, ledgerPath, rooms)) {
+            removeStoreFiles(ledgerPath);
+            rmdir(directory);
+            return 1;
+        }
+        for (size_t i = 0; i < 40; ++i) {
+            if (!rooms.isBooked[i]) {
+                runBenchmarkStay(store, rooms, i, false);
+            }
+        }
+        compactCustomerStore(store);
+        int written = 0;
+        for (size_t i = 0; written < changeCounts[c]; ++i, written += 3) {
+            runBenchmarkStay(store, rooms, 40 + i % 60, true);
+        }
+        close(store.journalFd);
+
+        double bestMs = 0;
+        for (int run = 0; run < 5; ++run) {
+            RoomTable restored = createRooms();
+            CustomerStore reopened;
+            start = chrono::steady_clock::now();
+            if (!openCustomerStore(reopened, ledgerPath, restored)) {
+                removeStoreFiles(ledgerPath);
+                rmdir(directory);
+                return 1;
+            }
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            bestMs = (run == 0) ? ms : min(bestMs, ms);
+            if (run == 4) {
+                closeCustomerStore(reopened); // Compacts, so the next round starts from a fresh snapshot
+            } else {
+                close(reopened.journalFd);
+            }
+        }
+        cout << "Startup, " << setw(4) << written << " changes since snapshot: " << setw(8) << bestMs << " ms" << endl;
+    }
+
+    removeStoreFiles(ledgerPath);
+    rmdir(directory);
+    return 0;
+}
+
+// Function to run a scripted front-desk workload against a synthetic hotel and history,
+// printing the operation timings as JSON (run with --bench [rooms] [ledger rows] [operations]).
+// The workload is the same for the same sizes, so runs can be compared for regressions.
+int runWorkloadBenchmark(long long roomCount, long long ledgerRows, long long operations) {
+    if (roomCount <= 0 || ledgerRows < 0 || operations < 0) {
+        cerr << "Usage: --bench [rooms] [ledger rows] [operations]" << endl;
+        return 1;
+    }
+    char directory[] = "/tmp/hotel-bench-XXXXXX";
+    if (mkdtemp(directory) == NULL) {
+        cerr << "Error: Could not create a benchmark directory." << endl;
+        return 1;
+    }
+    string ledgerPath = string(directory) + "/CustomerData.txt";
+    if (!writeSyntheticLedger(ledgerPath, ledgerRows, roomCount)) {
+        cerr << "Error: Could not write " << ledgerPath << "." << endl;
+        removeStoreFiles(ledgerPath);
+        rmdir(directory);
+        return 1;
+    }
+
+    RoomTable rooms = createBenchmarkRooms(roomCount);
+    CustomerStore store;
+    if (!openCustomerStore(store, ledgerPath, rooms)) {
+        removeStoreFiles(ledgerPath);
+        rmdir(directory);
+        return 1;
+    }
+    RoomInventory inventory;
+    buildRoomInventory(inventory, rooms);
+    ReservationCalendar calendar;
+    buildReservationCalendar(calendar, rooms, currentDay());
+    loadReservations(calendar, inventory, store);
+    ofstream sink("/dev/null"); // Reports are produced in full but not shown
+    ReportWriter writer;
+    writer.out = &sink;
+    int ledgerFd = open(ledgerPath.c_str(), O_RDONLY);
+
+    // Each step picks a room and moves it on: free -> booked -> checked in -> free.
+    // Every 500 steps one page of that room's history is read, every 5000 a summary.
+    unsigned seed = 2654435761u;
+    long long refused = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (long long step = 0; step < operations; ++step) {
+        seed = seed * 1103515245u + 12345u;
+        size_t slot = (seed >> 8) % roomCount;
+        string error;
+        if (!rooms.isBooked[slot]) {
+            BookingRequest request = { rooms.roomNumber[slot], "Bench Guest", "03001234567", "guest@example.com",
+                                       to_string(1 + (seed >> 4) % 4), "Cash", currentDay() };
+            error = placeBooking(rooms, inventory, calendar, store, request);
+        } else if (rooms.guest[slot].checkInTime.length == 0) {
+            error = completeCheckIn(rooms, store, slot, getCurrentTime());
+        } else {
+            error = completeCheckOut(rooms, inventory, calendar, store, slot);
+        }
+        refused += !error.empty();
+        if (step % 500 == 499) {
+            ReportFilter filter;
+            filter.roomNumber = rooms.roomNumber[slot];
+            ReportCursor cursor;
+            LedgerIndexView view;
+            if (openLedgerIndexView(store, view)) {
+                writeCustomerPage(store, view, filter, cursor, kReportPageSize, writer, ledgerFd);
+            }
+            closeLedgerIndexView(view);
+            flushReport(writer);
+        }
+        if (step % 5000 == 4999) {
+            generateSummaryReport(rooms, inventory, store, sink);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (ledgerFd >= 0) {
+        close(ledgerFd);
+    }
+    closeCustomerStore(store);
+
+    cout << "{\n  \"rooms\": " << roomCount << ",\n  \"ledgerRows\": " << ledgerRows << ",\n  \"operations\": " << operations
+         << ",\n  \"refused\": " << refused << ",\n  \"seconds\": " << fixed << setprecision(6) << seconds
+         << ",\n  \"operationsPerSecond\": " << setprecision(1) << operations / max(seconds, 1e-9)
+         << ",\n  \"timings\": " << operationTimingsJson(store.timings) << "\n}" << endl;
+
+    removeStoreFiles(ledgerPath);
+    rmdir(directory);
+    return refused == 0 ? 0 : 2;
+}
+
+// Function to hammer the hotel service from several threads. Checks that no room was
+// ever booked twice at once and that the journal agrees with memory, and reports
+// how throughput scales with the number of threads.
+int runStressTest(int maxThreads, int operations) {
+    char directory[] = "/tmp/hotel-stress-XXXXXX";
+    if (mkdtemp(directory) == NULL) {
+        cout << "Error: Could not create a stress test directory." << endl;
+        return 1;
+    }
+    string ledgerPath = string(directory) + "/CustomerData.txt";
+    bool passed = true;
+    double singleThreadRate = 0;
+
+    cout << "Threads  Operations  Stays   Time (ms)    Ops/s  Speedup" << endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RoomTable rooms = createRooms();
+        CustomerStore store;
+        if (!openCustomerStore(store, ledgerPath, rooms)) {
+            removeStoreFiles(ledgerPath);
+            rmdir(directory);
+            return 1;
+        }
+        RoomInventory inventory;
+        buildRoomInventory(inventory, rooms);
+        ReservationCalendar calendar;
+        buildReservationCalendar(calendar, rooms, currentDay());
+        loadReservations(calendar, inventory, store);
+        HotelService service;
+        startHotelService(service, rooms, inventory, calendar, store);
+
+        // Each worker books a random room and, if it got it, checks in and out again
+        size_t roomCount = rooms.roomNumber.size();
+        vector<atomic<int> > occupied(roomCount);
+        vector<atomic<int> > stays(roomCount);
+        atomic<int> doubleBookings(0);
+        atomic<int> failures(0);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.push_back(thread([&, t] {
+                unsigned seed = 2654435761u * (t + 1);
+                int done = 0;
+                int share = operations / threads + (t < operations % threads ? 1 : 0);
+                while (done < share) {
+                    seed = seed * 1103515245u + 12345u;
+                    size_t slot = (seed >> 8) % roomCount;
+                    BookingRequest request = { rooms.roomNumber[slot], "Stress Guest", "03001234567", "stress@example.com",
+                                               "1", "Cash", currentDay() };
+                    ++done;
+                    if (!serviceBookRoom(service, request).empty()) {
+                        continue; // Taken by another worker
+                    }
+                    if (occupied[slot].exchange(1) != 0) {
+                        ++doubleBookings;
+                    }
+                    ++stays[slot];
+                    failures += !serviceCheckInRoom(service, request.roomNumber, "").empty();
+                    occupied[slot] = 0;
+                    failures += !serviceCheckOutRoom(service, request.roomNumber).empty();
+                    done += 2;
+                }
+            }));
+        }
+        for (size_t t = 0; t < workers.size(); ++t) {
+            workers[t].join();
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        stopHotelService(service);
+
+        // Every stay ended, so every room is free and every stay is in the ledger after closing
+        long long totalStays = 0;
+        bool roomsFree = true;
+        for (size_t i = 0; i < roomCount; ++i) {
+            totalStays += stays[i];
+            roomsFree = roomsFree && !rooms.isBooked[i];
+        }
+        for (size_t type = 0; type < rooms.typeNames.size(); ++type) {
+            roomsFree = roomsFree && firstFreeRoom(inventory, type) != kNoRoom &&
+                        countFreeRooms(inventory, type) == (int)count(rooms.typeId.begin(), rooms.typeId.end(), type);
+        }
+        closeCustomerStore(store);
+        ifstream ledger(ledgerPath);
+        string line;
+        long long ledgerRows = 0;
+        while (getline(ledger, line)) {
+            ++ledgerRows;
+        }
+        RoomTable restored = createRooms();
+        CustomerStore reopened;
+        bool restoredFree = openCustomerStore(reopened, ledgerPath, restored) &&
+                            count(restored.isBooked.begin(), restored.isBooked.end(), 1) == 0 && reopened.bookings.empty();
+        close(reopened.journalFd);
+
+        double rate = (ms > 0) ? operations / (ms / 1000) : 0;
+        if (threads == 1) {
+            singleThreadRate = rate;
+        }
+        cout << setw(7) << threads << setw(12) << operations << setw(7) << totalStays << fixed << setprecision(1) << setw(12) << ms
+             << setprecision(0) << setw(9) << rate << setprecision(2) << setw(8) << rate / singleThreadRate << "x" << endl;
+
+        if (doubleBookings != 0 || failures != 0 || !roomsFree || ledgerRows != totalStays || !restoredFree) {
+            cout << "FAILED: " << doubleBookings << " double bookings, " << failures << " failed check-ins/outs, rooms "
+                 << (roomsFree ? "free" : "not free") << ", " << ledgerRows << " ledger rows for " << totalStays << " stays, "
+                 << (restoredFree ? "restart clean" : "restart not clean") << endl;
+            passed = false;
+        }
+        removeStoreFiles(ledgerPath);
+    }
+    rmdir(directory);
+    cout << (passed ? "All invariants held." : "Invariants violated!") << endl;
+    return passed ? 0 : 1;
+}
+
+// The checks and splitting that the parsing module replaced, kept for --bench-parse
+bool legacyIsValidEmail(const string& emailAddress) {
+    const regex email_regex("^[\\w-]+(\\.[\\w-]+)*@[a-zA-Z0-9-]+(\\.[a-zA-Z]{2,})+$");
+    return regex_match(emailAddress, email_regex);
+}
+
+bool legacyValidateCreditCard(const string& cardNumber) {
+    if (cardNumber.length() == 16) {
+        for (size_t i = 0; i < cardNumber.size(); ++i) {
+            if (!isdigit(cardNumber[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool legacyIsValidCustomerName(const string& customerName) {
+    if (customerName.empty()) {
+        return false;
+    }
+    for (size_t i = 0; i < customerName.size(); ++i) {
+        char c = customerName[i];
+        if (!(isalpha(c) || isspace(c) || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool legacyIsValidContactNumber(const string& contactNumber) {
+    return !contactNumber.empty() && contactNumber.length() >= 7 && contactNumber.length() <= 15 &&
+           all_of(contactNumber.begin(), contactNumber.end(), ::isdigit);
+}
+
+vector<string> legacySplitFields(const string& record) {
+    vector<string> fields;
+    stringstream ss(record);
+    string field;
+    while (getline(ss, field, ',')) {
+        fields.push_back(field);
+    }
+    if (!record.empty() && record[record.size() - 1] == ',') {
+        fields.push_back("");
+    }
+    return fields;
+}
+
+bool legacyVerifyJournalLine(const string& line, string& payload) {
+    if (line.size() < 10 || line[line.size() - 9] != ',') {
+        return false;
+    }
+    payload = line.substr(0, line.size() - 9);
+    return journalChecksum(payload) == line.substr(line.size() - 8);
+}
+
+long long parseBenchSink = 0; // Keeps the compiler from dropping the measured calls
+
+// Function to time a check over many calls, in nanoseconds per call
+template <typename Check>
+double nanosPerCall(long long calls, Check check) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long long sink = 0;
+    for (long long i = 0; i < calls; ++i) {
+        sink += check(i);
+    }
+    parseBenchSink += sink;
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / calls;
+}
+
+// Function to compare the validation and parsing functions with the ones they replaced
+int runParseBenchmark(long long calls) {
+    const string emails[] = { "john.doe@example.com", "a_b-c@mail-server.co.uk", "guest@example.com", "bad@", "no-at.example.com",
+                              "x@y.z", "first..last@example.com", ".lead@example.com", "user@domain.c0m", "user@123.com",
+                              "name+tag@example.com", "a@b@c.com", "UPPER@EXAMPLE.COM", "@example.com", "trailing.@example.com",
+                              "u@d.museum" };
+    const string cards[] = { "4111111111111111", "5500005555555559", "4111111111111112", "41111111111a1111", "411111111111" };
+    const string names[] = { "Alice Smith", "Jean-Luc Picard", "Bob", "R2D2", "Maria del Carmen Lopez" };
+    const string contacts[] = { "03001234567", "0300123", "123456789012345", "0300-123456", "12345" };
+    const string records[] = { "B,12,45,Guest Name,03001234567,guest@example.com,2,Cash,20744",
+                               "I,12,45,2026-10-18 09:30:00", "O,12,45,2026-10-20 11:00:00",
+                               "R,13,46,Another Guest,03007654321,another@example.org,14,Credit,20800" };
+    const size_t emailCount = sizeof(emails) / sizeof(emails[0]);
+    const size_t cardCount = sizeof(cards) / sizeof(cards[0]);
+    const size_t nameCount = sizeof(names) / sizeof(names[0]);
+    const size_t contactCount = sizeof(contacts) / sizeof(contacts[0]);
+    const size_t recordCount = sizeof(records) / sizeof(records[0]);
+
+    // The hand-written matcher must accept exactly what the regex accepts
+    int mismatches = 0;
+    for (size_t i = 0; i < emailCount; ++i) {
+        if (isValidEmail(emails[i]) != legacyIsValidEmail(emails[i])) {
+            cout << "Email matcher disagrees with the regex on: " << emails[i] << endl;
+            ++mismatches;
+        }
+    }
+
+    // The regex is built on every call, so far fewer calls give a stable figure
+    long long regexCalls = max(calls / 2000, 1LL);
+    cout << "Check                    Before (ns)  After (ns)  Speedup" << endl;
+    double before = nanosPerCall(regexCalls, [&](long long i) { return legacyIsValidEmail(emails[i % emailCount]); });
+    double after = nanosPerCall(calls, [&](long long i) { return isValidEmail(emails[i % emailCount]); });
+    cout << "Email                   " << fixed << setprecision(1) << setw(12) << before << setw(12) << after << setw(8)
+         << before / after << "x" << endl;
+
+    before = nanosPerCall(calls, [&](long long i) { return legacyValidateCreditCard(cards[i % cardCount]); });
+    after = nanosPerCall(calls, [&](long long i) { return validateCreditCard(cards[i % cardCount]); });
+    cout << "Card number (+ Luhn)    " << setw(12) << before << setw(12) << after << setw(8) << before / after << "x" << endl;
+
+    before = nanosPerCall(calls, [&](long long i) { return legacyIsValidCustomerName(names[i % nameCount]); });
+    after = nanosPerCall(calls, [&](long long i) { return isValidCustomerName(names[i % nameCount]); });
+    cout << "Customer name           " << setw(12) << before << setw(12) << after << setw(8) << before / after << "x" << endl;
+
+    before = nanosPerCall(calls, [&](long long i) { return legacyIsValidContactNumber(contacts[i % contactCount]); });
+    after = nanosPerCall(calls, [&](long long i) { return isValidContactNumber(contacts[i % contactCount]); });
+    cout << "Contact number          " << setw(12) << before << setw(12) << after << setw(8) << before / after << "x" << endl;
+
+    before = nanosPerCall(calls, [&](long long i) { return (int)legacySplitFields(records[i % recordCount]).size(); });
+    after = nanosPerCall(calls, [&](long long i) {
+        string_view fields[kMaxFields];
+        return (int)tokenizeFields(records[i % recordCount], fields, kMaxFields);
+    });
+    cout << "Journal record split    " << setw(12) << before << setw(12) << after << setw(8) << before / after << "x" << endl;
+
+    string lines[recordCount];
+    for (size_t i = 0; i < recordCount; ++i) {
+        lines[i] = journalLine(records[i]);
+        lines[i].erase(lines[i].size() - 1);
+    }
+    before = nanosPerCall(calls, [&](long long i) {
+        string payload;
+        return (int)legacyVerifyJournalLine(lines[i % recordCount], payload);
+    });
+    after = nanosPerCall(calls, [&](long long i) {
+        string_view payload;
+        return (int)verifyJournalLine(lines[i % recordCount], payload);
+    });
+    cout << "Journal line checksum   " << setw(12) << before << setw(12) << after << setw(8) << before / after << "x" << endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--bench") {
+        return runWorkloadBenchmark(argc >= 3 ? atoll(argv[2]) : 1000, argc >= 4 ? atoll(argv[3]) : 100000,
+                                    argc >= 5 ? atoll(argv[4]) : 20000);
+    }
+    if (argc >= 2 && string(argv[1]) == "--bench-startup") {
+        return runStartupBenchmark(argc >= 3 ? atoll(argv[2]) : 10000000);
+    }
+    if (argc >= 2 && string(argv[1]) == "--bench-rooms") {
+        return runRoomTableBenchmark(argc >= 3 ? atoll(argv[2]) : 100000);
+    }
+    if (argc >= 2 && string(argv[1]) == "--bench-parse") {
+        return runParseBenchmark(argc >= 3 ? atoll(argv[2]) : 2000000);
+    }
+    if (argc >= 2 && string(argv[1]) == "--stress") {
+        return runStressTest(argc >= 3 ? atoi(argv[2]) : 16, argc >= 4 ? atoi(argv[3]) : 3000);
+    }
+    if (argc >= 2 && string(argv[1]) == "--batch") {
+        return runBatch(argc >= 3 ? argv[2] : "-");
     }
 
+    RoomTable rooms = createRooms();
+
+    CustomerStore store;
+    if (!openCustomerStore(store, "CustomerData.txt", rooms)) {
+        return 1;
+    }
+    RoomInventory inventory;
+    buildRoomInventory(inventory, rooms);
+    ReservationCalendar calendar;
+    buildReservationCalendar(calendar, rooms, currentDay());
+    loadReservations(calendar, inventory, store);
+
     displayWelcomeScreen();
     displayHotelDescription();
 
     int choice;
-    bool found = false;  // Declare 'found' here to make it accessible in the switch block
+    size_t slot = kNoRoom;  // Declare 'slot' here to make it accessible in the switch block
     do {
         displayMenu();
         
@@ -697,7 +3974,7 @@ int main() {
             try {
                 cin >> choice;
                 if (cin.fail()) {
-                    throw invalid_argument("\033[31m\nInvalid input! Please enter a valid menu choice (1-8).\033[0m");
+                    throw invalid_argument("\033[31m\nInvalid input! Please enter a valid menu choice (1-10).\033[0m");
                 }
                 break;  // Exit the loop if valid input is received
             } catch (const invalid_argument& e) {
@@ -714,49 +3991,51 @@ int main() {
         switch (choice) {
             case 1:
                        
-                displayRooms(rooms);
+                displayRooms(rooms, inventory);
                 break;
             case 2:
              // Ask for the room number again to display room details
                 int roomNumber;
                 cout << "\033[34mEnter Room Number to View Details:\033[0m ";
                 cin >> roomNumber;
-                found = false;  // Reset the 'found' flag before searching for the room
-                for (size_t i = 0; i < rooms.size(); ++i) {
-                    if (rooms[i].roomNumber == roomNumber) {
-                        displayRoomDetails(rooms[i]); // Pass the specific room
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
+                slot = findRoomSlot(inventory, roomNumber);  // Look the room up by its number
+                if (slot != kNoRoom) {
+                    displayRoomDetails(rooms, slot); // Pass the specific room
+                } else {
                     cout << "\033[31mRoom " << roomNumber << " does not exist!\033[0m" << endl;
                 }
                 break;
             case 3:
-                bookRoom(rooms);
+                bookRoom(rooms, inventory, calendar, store);
                 break;
             case 4:
-            checkInRoom(rooms);
+            checkInRoom(rooms, inventory, calendar, store);
                  break;
             case 5:
-                displayCustomerDetails();
+                displayCustomerDetails(store);
                 break;
             case 6:
-                checkOutRoom(rooms);
+                checkOutRoom(rooms, inventory, calendar, store);
                 break;
             case 7:
-            generateSummaryReport(rooms);  // Display the summary report
+            generateSummaryReport(rooms, inventory, store);  // Display the summary report
                 break;
             case 8:
+                searchFreeRooms(rooms, calendar);
+                break;
+            case 9:
+                displayOperationTimings(store);
+                break;
+            case 10:
 
                 cout<<"\033[38;5;225mTHANK YOU FOR VISITING OUR HOTEL"<<endl;
                 cout << "Exiting program. Thank you!\033[0m" << endl;
+                closeCustomerStore(store);
                 break;
             default:
                 cout << "\033[31mInvalid choice! Please try again.\033[0m" << endl;
         }
-    } while (choice != 8);
+    } while (choice != 10);
 
     return 0;
 